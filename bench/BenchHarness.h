@@ -0,0 +1,183 @@
+#pragma once
+// 基准测试小框架 (只有头文件，不依赖第三方库)
+//
+// 用法:
+//   Bench::Runner runner(argc, argv);
+//   runner.run("grid.rebuild", {{"units", "10000"}}, [&](Bench::State& s) {
+//       for (int i = 0; i < s.iterations; ++i) { ... }
+//       s.items = s.iterations * 10000; // 可选：按 "每个元素" 报告
+//   });
+//   return runner.finish();
+//
+// 每个用例先按时间预算定出每个样本的迭代次数 (同时起到预热作用)，
+// 采若干个样本，报告每次操作 (或每个元素) 耗时的中位数 / 最小值 / 平均值 / p90
+// 结果打印成表格，同时写成 JSON，方便脚本比对两次运行、抓性能回退
+//
+// 命令行:
+//   --filter <子串>    只跑名字里含这个子串的用例
+//   --json <文件>      JSON 输出路径 (默认 battlesim_bench.json)
+//   --quick            时间预算减到 1/5 (冒烟测试用)
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Bench {
+
+// 防止结果被优化掉：告诉编译器这个值被读了 (GCC/Clang 用空的内联汇编，其余编译器写进 volatile 再读回来)
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile T sink;
+    sink = value;
+    T readBack = sink;
+    (void)readBack;
+#endif
+}
+
+using Params = std::vector<std::pair<std::string, std::string>>;
+
+// 一个样本的上下文：用例函数跑 iterations 次，可以改写 items (默认等于 iterations)
+// 计时只包含 run 回调里 pause/resume 之外的部分
+struct State {
+    long long iterations = 1;
+    long long items = 0;
+
+    void pause() { m_pausedAt = Clock::now(); }
+    void resume() { m_excluded += Clock::now() - m_pausedAt; }
+
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point m_pausedAt;
+    Clock::duration m_excluded{ 0 };
+};
+
+struct Result {
+    std::string name;
+    Params params;
+    long long iterations = 0; // 每个样本的迭代次数
+    int samples = 0;
+    double medianNs = 0, minNs = 0, meanNs = 0, p90Ns = 0; // 每个 item 的纳秒数
+};
+
+class Runner {
+public:
+    Runner(int argc, char* argv[]) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--filter" && i + 1 < argc) m_filter = argv[++i];
+            else if (arg == "--json" && i + 1 < argc) m_jsonPath = argv[++i];
+            else if (arg == "--quick") m_budgetScale = 0.2;
+        }
+    }
+
+    bool selected(const std::string& name) const {
+        return m_filter.empty() || name.find(m_filter) != std::string::npos;
+    }
+
+    // 时间预算 (秒)，慢的用例 (整帧、大地图) 可以单独放宽或收紧
+    template <typename Fn>
+    void run(const std::string& name, const Params& params, Fn&& fn, double budgetSeconds = 0.5, int maxSamples = 15) {
+        if (!selected(name)) return;
+
+        // 预热 + 定迭代次数：从 1 次开始翻倍，直到一个样本的耗时接近 预算/样本数
+        double budget = budgetSeconds * m_budgetScale;
+        double perSample = budget / maxSamples;
+        int samples = maxSamples;
+        long long iterations = 1;
+        double seconds = timeSample(fn, iterations, nullptr);
+        while (seconds < perSample * 0.5) {
+            long long grow = seconds > 0 ? static_cast<long long>(perSample / seconds) : 2;
+            iterations *= std::max(2LL, std::min(grow, 10LL));
+            seconds = timeSample(fn, iterations, nullptr);
+        }
+        if (seconds > perSample) {
+            // 一个样本就超了：减少样本数，至少 3 个
+            samples = std::max(3, std::min(maxSamples, static_cast<int>(budget / seconds)));
+        }
+
+        std::vector<double> perItem;
+        for (int s = 0; s < samples; ++s) {
+            long long items = 0;
+            double seconds = timeSample(fn, iterations, &items);
+            perItem.push_back(seconds * 1e9 / static_cast<double>(std::max(1LL, items)));
+        }
+        std::sort(perItem.begin(), perItem.end());
+
+        Result r;
+        r.name = name;
+        r.params = params;
+        r.iterations = iterations;
+        r.samples = samples;
+        r.medianNs = perItem[perItem.size() / 2];
+        r.minNs = perItem.front();
+        r.p90Ns = perItem[std::min(perItem.size() - 1, perItem.size() * 9 / 10)];
+        double sum = 0;
+        for (double v : perItem) sum += v;
+        r.meanNs = sum / perItem.size();
+        m_results.push_back(r);
+
+        std::string label = name;
+        for (const auto& p : params) label += " " + p.first + "=" + p.second;
+        std::printf("%-52s %12s/op  (min %s, %d x %lld)\n", label.c_str(), formatNs(r.medianNs).c_str(),
+                    formatNs(r.minNs).c_str(), samples, iterations);
+        std::fflush(stdout);
+    }
+
+    // 写 JSON，返回进程退出码
+    int finish() const {
+        std::FILE* f = std::fopen(m_jsonPath.c_str(), "w");
+        if (!f) {
+            std::fprintf(stderr, "cannot write %s\n", m_jsonPath.c_str());
+            return 1;
+        }
+        std::fprintf(f, "{\n  \"benchmarks\": [\n");
+        for (std::size_t i = 0; i < m_results.size(); ++i) {
+            const Result& r = m_results[i];
+            std::fprintf(f, "    {\"name\": \"%s\", \"params\": {", r.name.c_str());
+            for (std::size_t p = 0; p < r.params.size(); ++p) {
+                std::fprintf(f, "%s\"%s\": \"%s\"", p ? ", " : "", r.params[p].first.c_str(), r.params[p].second.c_str());
+            }
+            std::fprintf(f, "}, \"samples\": %d, \"iterations\": %lld, "
+                            "\"ns_per_op\": {\"median\": %.3f, \"min\": %.3f, \"mean\": %.3f, \"p90\": %.3f}}%s\n",
+                         r.samples, r.iterations, r.medianNs, r.minNs, r.meanNs, r.p90Ns,
+                         i + 1 < m_results.size() ? "," : "");
+        }
+        std::fprintf(f, "  ]\n}\n");
+        std::fclose(f);
+        std::printf("wrote %zu results to %s\n", m_results.size(), m_jsonPath.c_str());
+        return 0;
+    }
+
+private:
+    template <typename Fn>
+    static double timeSample(Fn& fn, long long iterations, long long* items) {
+        State state;
+        state.iterations = iterations;
+        auto t0 = State::Clock::now();
+        fn(state);
+        auto t1 = State::Clock::now();
+        if (items) *items = state.items > 0 ? state.items : iterations;
+        return std::chrono::duration<double>(t1 - t0 - state.m_excluded).count();
+    }
+
+    static std::string formatNs(double ns) {
+        char buf[32];
+        if (ns < 1e3) std::snprintf(buf, sizeof(buf), "%.2f ns", ns);
+        else if (ns < 1e6) std::snprintf(buf, sizeof(buf), "%.2f us", ns / 1e3);
+        else std::snprintf(buf, sizeof(buf), "%.2f ms", ns / 1e6);
+        return buf;
+    }
+
+    std::string m_filter;
+    std::string m_jsonPath = "battlesim_bench.json";
+    double m_budgetScale = 1.0;
+    std::vector<Result> m_results;
+};
+
+} // namespace Bench
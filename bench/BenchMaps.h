@@ -0,0 +1,56 @@
+#pragma once
+// 基准测试共用的地图和寻路查询生成 (pathfinding_bench / battlesim_bench)
+#include <random>
+#include <utility>
+#include <vector>
+#include <SFML/System.hpp>
+#include "TileMap.h"
+
+namespace BenchMaps {
+
+// 随机深度优先生成迷宫：奇数行列是房间，打通相邻房间之间的墙
+inline void makeMaze(int rows, int cols, TileMap& map, unsigned seed) {
+    map.create(rows, cols, MOUNTAIN);
+    std::mt19937 rng(seed);
+    std::vector<sf::Vector2i> stack;
+    stack.push_back(sf::Vector2i(1, 1));
+    map.set(1, 1, GROUND);
+
+    const int dx[] = { 2, -2, 0, 0 };
+    const int dy[] = { 0, 0, 2, -2 };
+    while (!stack.empty()) {
+        sf::Vector2i cur = stack.back();
+        int options[4];
+        int count = 0;
+        for (int i = 0; i < 4; ++i) {
+            int nx = cur.x + dx[i], ny = cur.y + dy[i];
+            if (nx > 0 && nx < cols - 1 && ny > 0 && ny < rows - 1 && map.at(ny, nx) == MOUNTAIN) {
+                options[count++] = i;
+            }
+        }
+        if (count == 0) {
+            stack.pop_back();
+            continue;
+        }
+        int i = options[rng() % count];
+        map.set(cur.y + dy[i] / 2, cur.x + dx[i] / 2, GROUND);
+        map.set(cur.y + dy[i], cur.x + dx[i], GROUND);
+        stack.push_back(sf::Vector2i(cur.x + dx[i], cur.y + dy[i]));
+    }
+}
+
+// 在可通行格子里随机取起终点
+inline std::vector<std::pair<sf::Vector2i, sf::Vector2i>> makeQueries(const TileMap& map, int count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::vector<std::pair<sf::Vector2i, sf::Vector2i>> queries;
+    auto pick = [&]() {
+        while (true) {
+            sf::Vector2i p(rng() % map.cols(), rng() % map.rows());
+            if (map.isPassable(p.y, p.x)) return p;
+        }
+    };
+    for (int i = 0; i < count; ++i) queries.push_back({ pick(), pick() });
+    return queries;
+}
+
+} // namespace BenchMaps
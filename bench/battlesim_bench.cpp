@@ -0,0 +1,236 @@
+// 核心热点路径的基准测试套件 (结果写成 JSON，便于比对两次运行、抓回退)
+// 用法: battlesim_bench [--filter 子串] [--json 文件] [--quick]
+//
+// 用例：
+//   pathfinding.findPath      64 / 256 / 1024 见方，开阔 / 15% 障碍 / 30% 障碍 / 迷宫，A* 和 JPS
+//   unit.findClosestEnemy     平均每格 0.25 / 1 / 4 / 16 个单位时的一次索敌
+//   grid.rebuild              1k / 10k / 100k 个单位的空间网格重建
+//   projectiles.tick          稳定保持 1k / 10k 颗子弹在飞：每帧发射一批 + 更新 + 伤害结算
+//   game.tick                 无窗口 Game 的一个完整逻辑帧，100 / 1k / 10k 个单位 (敌方 AI 关闭)
+// 单个热点的横向对比 (A* vs JPS、标量 vs SIMD) 见同目录下的专项基准
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "BenchHarness.h"
+#include "BenchMaps.h"
+#include "DamageBuffer.h"
+#include "EventBus.h"
+#include "FrameArena.h"
+#include "Game.h"
+#include "MapFile.h"
+#include "Pathfinder.h"
+#include "ProjectileSystem.h"
+#include "Unit.h"
+
+namespace {
+    // 把受保护的索敌函数露出来
+    class ProbeKnight : public Knight {
+    public:
+        using Knight::Knight;
+        using Unit::findClosestEnemy;
+    };
+
+    // 一组单位 + 网格 + 句柄 (不经过 Game)
+    struct Crowd {
+        EventBus bus;
+        UnitHandleTable handles;
+        SpatialGrid grid;
+        std::vector<std::unique_ptr<ProbeKnight>> units;
+
+        // rows x cols 的地图上随机撒 count 个单位，两队各一半
+        Crowd(int rows, int cols, int count, unsigned seed) {
+            handles.attach(bus);
+            grid.resize(rows, cols);
+            std::mt19937 rng(seed);
+            std::uniform_real_distribution<float> x(0.f, cols * Game::TILE_SIZE - 1.f);
+            std::uniform_real_distribution<float> y(0.f, rows * Game::TILE_SIZE - 1.f);
+            for (int i = 0; i < count; ++i) {
+                units.push_back(std::make_unique<ProbeKnight>(x(rng), y(rng), (i & 1) ? TEAM_B : TEAM_A));
+                bus.publish({ GameEventType::UNIT_SPAWNED, units.back().get() });
+            }
+            rebuild();
+        }
+
+        void rebuild() {
+            grid.clear();
+            for (const auto& u : units) {
+                grid.insert(u.get(), static_cast<int>(u->getPosition().y) / Game::TILE_SIZE,
+                            static_cast<int>(u->getPosition().x) / Game::TILE_SIZE);
+            }
+        }
+    };
+
+    std::string str(double v) {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%g", v);
+        return buf;
+    }
+
+    // --- 寻路 ---
+    void benchPathfinding(Bench::Runner& runner) {
+        const int sizes[] = { 64, 256, 1024 };
+        for (int size : sizes) {
+            struct Case { const char* name; TileMap map; };
+            std::vector<Case> cases;
+            {
+                Case open{ "open", {} };
+                open.map.create(size, size, GROUND);
+                cases.push_back(std::move(open));
+            }
+            const float densities[] = { 0.15f, 0.30f };
+            const char* densityNames[] = { "rocks15", "rocks30" };
+            for (int d = 0; d < 2; ++d) {
+                MapData data;
+                MapFile::generate(size, size, data, densities[d], 7);
+                cases.push_back(Case{ densityNames[d], std::move(data.tiles) });
+            }
+            {
+                Case maze{ "maze", {} };
+                BenchMaps::makeMaze(size + 1, size + 1, maze.map, 7);
+                cases.push_back(std::move(maze));
+            }
+
+            for (const Case& c : cases) {
+                auto queries = BenchMaps::makeQueries(c.map, 32, 12345);
+                const PathMode modes[] = { PathMode::ASTAR, PathMode::JPS };
+                const char* modeNames[] = { "astar", "jps" };
+                for (int m = 0; m < 2; ++m) {
+                    // 一次迭代跑完整组查询，按单次查询报告 (各条查询的耗时差得很远，只取一条没法估计)
+                    runner.run("pathfinding.findPath",
+                               { { "size", std::to_string(size) }, { "map", c.name }, { "mode", modeNames[m] } },
+                               [&](Bench::State& s) {
+                                   for (long long i = 0; i < s.iterations; ++i) {
+                                       for (const auto& q : queries) {
+                                           Bench::doNotOptimize(Pathfinder::findPath(c.map, q.first, q.second, modes[m]).size());
+                                           FrameArena::forThread().reset(); // 相当于帧末回收
+                                       }
+                                   }
+                                   s.items = s.iterations * static_cast<long long>(queries.size());
+                               });
+                }
+            }
+        }
+    }
+
+    // --- 索敌 ---
+    void benchFindClosestEnemy(Bench::Runner& runner) {
+        const int side = 64;
+        const double densities[] = { 0.25, 1.0, 4.0, 16.0 };
+        for (double density : densities) {
+            if (!runner.selected("unit.findClosestEnemy")) return;
+            Crowd crowd(side, side, static_cast<int>(side * side * density), 3);
+            std::size_t next = 0;
+            runner.run("unit.findClosestEnemy", { { "units_per_cell", str(density) }, { "units", std::to_string(crowd.units.size()) } },
+                       [&](Bench::State& s) {
+                           for (long long i = 0; i < s.iterations; ++i) {
+                               ProbeKnight& probe = *crowd.units[next++ % crowd.units.size()];
+                               Bench::doNotOptimize(probe.findClosestEnemy(crowd.grid));
+                           }
+                       });
+        }
+    }
+
+    // --- 网格重建 ---
+    void benchGridRebuild(Bench::Runner& runner) {
+        const int counts[] = { 1000, 10000, 100000 };
+        for (int count : counts) {
+            if (!runner.selected("grid.rebuild")) return;
+            int side = static_cast<int>(std::ceil(std::sqrt(count * 2.0))); // 平均每格 0.5 个
+            Crowd crowd(side, side, count, 5);
+            runner.run("grid.rebuild", { { "units", std::to_string(count) } }, [&](Bench::State& s) {
+                for (long long i = 0; i < s.iterations; ++i) crowd.rebuild();
+            });
+        }
+    }
+
+    // --- 子弹 ---
+    void benchProjectiles(Bench::Runner& runner) {
+        const int populations[] = { 1000, 10000 };
+        for (int population : populations) {
+            if (!runner.selected("projectiles.tick")) return;
+            Crowd crowd(64, 64, 512, 9);
+            DamageBuffer damage(crowd.handles);
+            ProjectileSystem projectiles(crowd.handles, damage);
+
+            // 目标在 300~500 像素外：炮弹约 1~1.5 秒命中，箭和吹箭更快
+            // 每帧发射 population / 60 颗，稳定后在飞的数量约为 population
+            const float dt = 1.f / 60.f;
+            const int perTick = population / 60;
+            std::mt19937 rng(11);
+            std::uniform_real_distribution<float> angle(0.f, 6.2831853f);
+            std::uniform_real_distribution<float> range(300.f, 500.f);
+            auto tick = [&]() {
+                for (int i = 0; i < perTick; ++i) {
+                    const Unit* target = crowd.units[rng() % crowd.units.size()].get();
+                    float a = angle(rng), r = range(rng);
+                    sf::Vector2f from = target->getPosition() + sf::Vector2f(std::cos(a) * r, std::sin(a) * r);
+                    projectiles.spawn(from, target, 1.f, static_cast<ProjectileKind>(i % static_cast<int>(ProjectileKind::COUNT)));
+                }
+                projectiles.update(dt);
+                damage.resolve();
+            };
+            for (int i = 0; i < 180; ++i) tick(); // 先跑到稳定状态
+
+            runner.run("projectiles.tick", { { "target_in_flight", std::to_string(population) } }, [&](Bench::State& s) {
+                for (long long i = 0; i < s.iterations; ++i) tick();
+            });
+        }
+    }
+
+    // --- 整帧 ---
+    // 无窗口 Game，两队各占自己那半张地图 (上半 TEAM_A，下半 TEAM_B)，兵种轮流
+    std::unique_ptr<Game> makeBattle(int count) {
+        const UnitType mix[] = { UnitType::KNIGHT, UnitType::ARCHERS, UnitType::GIANT,
+                                 UnitType::VALKYRIE, UnitType::DART_GOBLIN, UnitType::PEKKA };
+        // 平均每 4 格一个单位，地图至少是默认大小
+        int side = std::max(Game::DEFAULT_COLS, static_cast<int>(std::ceil(std::sqrt(count * 4.0))));
+        MapData map;
+        MapFile::generate(side, side, map, 0.f, 1);
+        auto game = std::make_unique<Game>(std::move(map), true);
+        game->setAIEnabled(false);
+
+        const TileMap& tiles = game->map().tiles;
+        std::mt19937 rng(21);
+        for (int i = 0; i < count; ++i) {
+            int team = i & 1;
+            int r, c;
+            do {
+                r = static_cast<int>(rng() % (side / 2)) + (team == TEAM_A ? 0 : side - side / 2);
+                c = static_cast<int>(rng() % side);
+            } while (!tiles.isPassable(r, c));
+            game->spawnUnit(mix[(i / 2) % 6], (c + 0.5f) * Game::TILE_SIZE, (r + 0.5f) * Game::TILE_SIZE, team);
+        }
+        return game;
+    }
+
+    void benchGameTick(Bench::Runner& runner) {
+        const int counts[] = { 100, 1000, 10000 };
+        for (int count : counts) {
+            // 战局会演化 (交战、减员)，每个样本都从同一个开局重新跑，样本之间才可比
+            // 建局和前 30 帧 (寻路请求、休眠状态稳定下来) 不计时
+            runner.run("game.tick", { { "units", std::to_string(count) } }, [&](Bench::State& s) {
+                const float dt = 1.f / 60.f;
+                s.pause();
+                std::unique_ptr<Game> game = makeBattle(count);
+                for (int i = 0; i < 30; ++i) game->step(dt);
+                s.resume();
+                for (long long i = 0; i < s.iterations; ++i) game->step(dt);
+                s.pause();
+                game.reset();
+                s.resume();
+            }, 2.0, 20);
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Bench::Runner runner(argc, argv);
+    benchPathfinding(runner);
+    benchFindClosestEnemy(runner);
+    benchGridRebuild(runner);
+    benchProjectiles(runner);
+    benchGameTick(runner);
+    return runner.finish();
+}
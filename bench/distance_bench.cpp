@@ -0,0 +1,103 @@
+// 批量距离核基准测试：标量 / SSE / AVX2
+// 用法: distance_bench [每组的重复次数，默认 20000]
+//
+// 两个核：
+//   nearest  半径内最近候选 (索敌)
+//   within   半径内全部候选 (范围伤害)
+// 候选数取 8 / 32 / 128 / 1024：前几档对应一次索敌在周围格子里收集到的规模，
+// 最后一档看纯吞吐。输出每个候选的平均耗时 (ns) 和相对标量的倍数
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "DistanceKernels.h"
+
+namespace {
+    using DistanceKernels::Isa;
+
+    struct Batch {
+        std::vector<float> xs, ys;
+        std::vector<float> px, py; // 每次查询的中心点
+    };
+
+    Batch makeBatch(int count, int queries, unsigned seed) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> coord(0.f, 640.f);
+        Batch b;
+        for (int i = 0; i < count; ++i) {
+            b.xs.push_back(coord(rng));
+            b.ys.push_back(coord(rng));
+        }
+        for (int i = 0; i < queries; ++i) {
+            b.px.push_back(coord(rng));
+            b.py.push_back(coord(rng));
+        }
+        return b;
+    }
+
+    // 返回每个候选的平均纳秒数；sink 防止结果被优化掉
+    double timeNearest(const Batch& b, int reps, long long& sink) {
+        const int count = static_cast<int>(b.xs.size());
+        const int queries = static_cast<int>(b.px.size());
+        auto t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < reps; ++r) {
+            int q = r % queries;
+            sink += DistanceKernels::nearest(b.xs.data(), b.ys.data(), count, b.px[q], b.py[q], 150.f * 150.f);
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(t1 - t0).count() / (static_cast<double>(reps) * count);
+    }
+
+    double timeWithin(const Batch& b, int reps, long long& sink) {
+        const int count = static_cast<int>(b.xs.size());
+        const int queries = static_cast<int>(b.px.size());
+        std::vector<int> out(count);
+        auto t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < reps; ++r) {
+            int q = r % queries;
+            sink += DistanceKernels::withinRadius(b.xs.data(), b.ys.data(), count, b.px[q], b.py[q], 60.f * 60.f, out.data());
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(t1 - t0).count() / (static_cast<double>(reps) * count);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int reps = argc > 1 ? std::atoi(argv[1]) : 20000;
+    const int counts[] = { 8, 32, 128, 1024 };
+    const Isa isas[] = { Isa::SCALAR, Isa::SSE, Isa::AVX2 };
+    long long sink = 0;
+
+    const Isa best = DistanceKernels::activeIsa();
+    std::printf("cpu best isa: %s\n", DistanceKernels::isaName(best));
+
+    for (int count : counts) {
+        Batch batch = makeBatch(count, 256, 7);
+        double scalarNearest = 0.0, scalarWithin = 0.0;
+        for (Isa isa : isas) {
+            DistanceKernels::setIsa(isa);
+            if (DistanceKernels::activeIsa() != isa) continue; // CPU 不支持，跳过
+
+            // 数据量小，重复次数按候选数缩放，保证每组跑的总候选数差不多
+            int scaled = reps / 8 * (1024 / count) + 1;
+            timeNearest(batch, scaled / 10 + 1, sink); // 预热
+            double nearestNs = timeNearest(batch, scaled, sink);
+            double withinNs = timeWithin(batch, scaled, sink);
+            if (isa == Isa::SCALAR) {
+                scalarNearest = nearestNs;
+                scalarWithin = withinNs;
+            }
+
+            std::printf("n=%-5d %-6s  nearest %7.3f ns/cand (x%4.2f)  within %7.3f ns/cand (x%4.2f)\n",
+                        count, DistanceKernels::isaName(isa),
+                        nearestNs, scalarNearest / nearestNs,
+                        withinNs, scalarWithin / withinNs);
+        }
+    }
+    DistanceKernels::setIsa(best);
+
+    // 打印 sink，防止整个循环被当成死代码删掉
+    std::printf("checksum %lld\n", sink);
+    return 0;
+}
@@ -0,0 +1,164 @@
+// 空间网格条目布局基准测试：按插入顺序留在原地 vs 按格子的 Z 序重排 (SpatialGrid::sortByCell)
+// 用法: grid_layout_bench [逻辑帧数，默认 120] [每格平均单位数，默认 4 (部队扎堆)；0.5 接近散开的兵线]
+//
+// 单位按随机位置、随机顺序生成 (和实战里 "按生成时间排列" 一样，列表顺序和位置无关)，
+// 然后跑无窗口的逻辑帧：单位 update (索敌扫描周围格子) + 伤害结算 + 网格重建。
+// 两种配置用同一批单位：
+//   linked     网格条目按插入顺序留在原地，同一格的条目散在整个数组里
+//   sorted     每次重建后调用 sortByCell，同格、邻格的条目连成一片
+// 所有单位同一阵营，索敌永远扫不到敌人：不会死人、不会追击，每帧的工作量完全一样，
+// 测到的差别只来自访问顺序 (sorted 的耗时包含每帧排序本身)。
+// Linux 上同时读硬件计数器 (缓存未命中)，没有权限或虚拟机没有暴露 PMU 时只输出耗时
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "Unit.h"
+#include "DamageBuffer.h"
+#include "EventBus.h"
+#include "ProjectileSystem.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    // 一个硬件计数器 (只统计本进程的用户态)
+    enum class CounterKind { CACHE_MISSES, L1D_READ_MISSES };
+
+    class PerfCounter {
+    public:
+        explicit PerfCounter(CounterKind kind) {
+#ifdef __linux__
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            if (kind == CounterKind::CACHE_MISSES) {
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CACHE_MISSES; // 一般是末级缓存
+            } else {
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            }
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            m_fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#else
+            (void)kind;
+#endif
+        }
+        ~PerfCounter() {
+#ifdef __linux__
+            if (m_fd >= 0) close(m_fd);
+#endif
+        }
+        void start() {
+#ifdef __linux__
+            if (m_fd < 0) return;
+            ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+        }
+        long long stop() {
+            long long value = -1;
+#ifdef __linux__
+            if (m_fd < 0) return -1;
+            ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(m_fd, &value, sizeof(value)) != sizeof(value)) value = -1;
+#endif
+            return value;
+        }
+    private:
+        int m_fd = -1;
+    };
+
+    struct World {
+        TileMap map;
+        SpatialGrid grid;
+        EventBus bus;
+        UnitHandleTable handles;
+        DamageBuffer damage{ handles };
+        ProjectileSystem projectiles{ handles, damage };
+        PathScheduler paths;
+        std::vector<Unit*> units;
+
+        ~World() { for (Unit* u : units) delete u; }
+
+        void rebuildGrid(bool sortGrid) {
+            grid.clear();
+            for (Unit* u : units) {
+                grid.insert(u, static_cast<int>(u->getPosition().y) / Game::TILE_SIZE,
+                            static_cast<int>(u->getPosition().x) / Game::TILE_SIZE);
+            }
+            if (sortGrid) grid.sortByCell();
+        }
+    };
+
+    void populate(World& world, int count, float density, unsigned seed, bool sortGrid) {
+        int side = 1;
+        while (side * side * density < count) side++;
+        world.map.create(side, side, GROUND);
+        world.grid.resize(side, side);
+        world.handles.attach(world.bus);
+
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> coord(0.f, static_cast<float>(side * Game::TILE_SIZE - 1));
+        for (int i = 0; i < count; ++i) {
+            float x = coord(rng), y = coord(rng);
+            Unit* u = (i % 3 == 0) ? static_cast<Unit*>(new Archers(x, y, TEAM_A)) : static_cast<Unit*>(new Knight(x, y, TEAM_A));
+            u->setStrategicTarget(x, y); // 原地待命
+            world.units.push_back(u);
+            world.bus.publish({ GameEventType::UNIT_SPAWNED, u });
+        }
+        world.rebuildGrid(sortGrid);
+    }
+
+    void run(const char* name, int count, float density, int ticks, bool sortGrid) {
+        World world;
+        populate(world, count, density, 7, sortGrid);
+
+        PerfCounter cacheMisses(CounterKind::CACHE_MISSES);
+        PerfCounter l1dMisses(CounterKind::L1D_READ_MISSES);
+
+        const float dt = 1.f / 60.f;
+        cacheMisses.start();
+        l1dMisses.start();
+        auto t0 = std::chrono::steady_clock::now();
+        for (int t = 0; t < ticks; ++t) {
+            for (Unit* u : world.units) {
+                u->update(dt, world.grid, world.projectiles, world.damage, world.map, world.paths);
+            }
+            world.paths.update(world.map);
+            world.projectiles.update(dt);
+            world.damage.resolve();
+            world.rebuildGrid(sortGrid);
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        long long llc = cacheMisses.stop();
+        long long l1 = l1dMisses.stop();
+
+        double ms = std::chrono::duration<double, std::milli>(t1 - t0).count() / ticks;
+        std::printf("%-9s units %7d  %8.3f ms/tick", name, count, ms);
+        if (llc >= 0) std::printf("  cache-miss/tick %10.0f", static_cast<double>(llc) / ticks);
+        else std::printf("  cache-miss/tick        n/a");
+        if (l1 >= 0) std::printf("  L1D-miss/tick %10.0f", static_cast<double>(l1) / ticks);
+        else std::printf("  L1D-miss/tick        n/a");
+        std::printf("\n");
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int ticks = argc > 1 ? std::atoi(argv[1]) : 120;
+    float density = argc > 2 ? static_cast<float>(std::atof(argv[2])) : 4.f;
+    if (density <= 0.f) density = 4.f;
+    const int counts[] = { 10000, 50000, 100000 };
+    for (int count : counts) {
+        run("linked", count, density, ticks, false);
+        run("sorted", count, density, ticks, true);
+    }
+    return 0;
+}
@@ -0,0 +1,146 @@
+// 分时寻路调度器的压力测试：积压时每帧耗时、各类请求的等待帧数、追击单位会不会饿死
+// 用法: path_scheduler_bench [帧数，默认 600] [追击单位数，默认 200]
+//
+// 场景 (400x400，15% 山脉)：
+//   - 第 0 帧一座塔倒下，500 个推塔单位同时改道 (STRATEGIC)
+//   - 200 个 (可调) 追击单位，各自的敌人每 15 帧挪一格；没路时提交 COMBAT，
+//     有路时每 30 帧 (0.5 秒) 换一次路 (REPLAN)，和 Unit::update 里的追击逻辑一致
+// 单位本身不动，只统计调度：
+//   每帧 PathScheduler::update 的耗时分布、每次请求从提交到送回的等待帧数、结束时仍未送达的单位数
+// 追击单位多到一轮换路 30 帧内处理不完时 (例如 1000 个)，就是持续积压的情况：
+// 重发请求如果排到队尾，部分追击单位会一直等下去
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+#include "Game.h"
+#include "MapFile.h"
+#include "PathScheduler.h"
+#include "Unit.h"
+
+namespace {
+    struct Tracked {
+        std::unique_ptr<Unit> unit;
+        int submittedAt = -1;   // 当前这次等待从哪一帧开始 (-1 = 没在等)
+        sf::Vector2i enemy;     // 追击单位的目标格
+        int repathTimer = 0;
+        bool everServed = false;
+    };
+
+    sf::Vector2f cellCenter(sf::Vector2i cell) {
+        return sf::Vector2f((cell.x + 0.5f) * Game::TILE_SIZE, (cell.y + 0.5f) * Game::TILE_SIZE);
+    }
+
+    sf::Vector2i randomCell(const TileMap& map, std::mt19937& rng, int row0, int row1) {
+        for (;;) {
+            int r = row0 + static_cast<int>(rng() % (row1 - row0));
+            int c = static_cast<int>(rng() % map.cols());
+            if (map.isPassable(r, c)) return sf::Vector2i(c, r);
+        }
+    }
+
+    void printWaits(const char* name, std::vector<int>& waits) {
+        if (waits.empty()) {
+            std::printf("%-10s no deliveries\n", name);
+            return;
+        }
+        std::sort(waits.begin(), waits.end());
+        auto pick = [&waits](double q) { return waits[static_cast<std::size_t>(q * (waits.size() - 1) + 0.5)]; };
+        std::printf("%-10s deliveries %6zu  wait ticks p50 %4d  p99 %4d  max %4d\n",
+                    name, waits.size(), pick(0.50), pick(0.99), waits.back());
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const int ticks = argc > 1 ? std::max(1, std::atoi(argv[1])) : 600;
+    const int chaserCount = argc > 2 ? std::max(1, std::atoi(argv[2])) : 200;
+    const int size = 400;
+    MapData data;
+    MapFile::generate(size, size, data, 0.15f, 7);
+    const TileMap& map = data.tiles;
+    std::mt19937 rng(42);
+
+    PathScheduler scheduler;
+    std::vector<Tracked> strategic(500), chasers(chaserCount);
+    const sf::Vector2i tower = randomCell(map, rng, size - 6, size - 3);
+    for (auto& t : strategic) {
+        t.unit = std::make_unique<Knight>(0.f, 0.f, TEAM_A);
+        t.unit->setPosition(cellCenter(randomCell(map, rng, 3, size / 2 - 2)));
+    }
+    for (auto& t : chasers) {
+        sf::Vector2i cell = randomCell(map, rng, 3, size / 2 - 2);
+        t.unit = std::make_unique<Knight>(0.f, 0.f, TEAM_A);
+        t.unit->setPosition(cellCenter(cell));
+        t.enemy = randomCell(map, rng, std::min(cell.y + 10, size / 2 - 3), size / 2 - 2);
+        t.repathTimer = static_cast<int>(rng() % 30); // 错开相位
+    }
+
+    std::vector<double> tickMs;
+    std::vector<int> strategicWaits, chaserWaits;
+    auto submit = [&](Tracked& t, sf::Vector2i goal, PathUrgency urgency, int tick) {
+        if (t.submittedAt < 0) t.submittedAt = tick;
+        sf::Vector2f target = cellCenter(goal);
+        t.unit->setTarget(target.x, target.y, scheduler, urgency);
+    };
+    auto collect = [](std::vector<Tracked>& group, std::vector<int>& waits, int tick) {
+        for (auto& t : group) {
+            if (t.submittedAt >= 0 && !t.unit->isPathPending()) {
+                waits.push_back(tick - t.submittedAt);
+                t.submittedAt = -1;
+                t.everServed = true;
+            }
+        }
+    };
+
+    for (int tick = 0; tick < ticks; ++tick) {
+        if (tick == 0) {
+            for (auto& t : strategic) submit(t, tower, PathUrgency::STRATEGIC, tick);
+        }
+        for (auto& t : chasers) {
+            // 敌人慢慢走开 (不走进不可通行的格子)
+            if (tick % 15 == 0) {
+                sf::Vector2i next(t.enemy.x + static_cast<int>(rng() % 3) - 1, t.enemy.y + static_cast<int>(rng() % 3) - 1);
+                if (map.isPassable(next.y, next.x)) t.enemy = next;
+            }
+            if (--t.repathTimer <= 0) {
+                t.repathTimer = 30;
+                submit(t, t.enemy, t.everServed ? PathUrgency::REPLAN : PathUrgency::COMBAT, tick);
+            }
+        }
+
+        auto t0 = std::chrono::steady_clock::now();
+        scheduler.update(map);
+        auto t1 = std::chrono::steady_clock::now();
+        tickMs.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+
+        collect(strategic, strategicWaits, tick);
+        collect(chasers, chaserWaits, tick);
+    }
+
+    std::sort(tickMs.begin(), tickMs.end());
+    auto pickMs = [&tickMs](double q) { return tickMs[static_cast<std::size_t>(q * (tickMs.size() - 1) + 0.5)]; };
+    std::printf("%d ticks, budget %.1f ms / %d expansions\n", ticks, scheduler.budget().maxMillis, scheduler.budget().maxExpansions);
+    std::printf("scheduler update  p50 %.3f ms  p99 %.3f ms  max %.3f ms\n", pickMs(0.50), pickMs(0.99), tickMs.back());
+    printWaits("strategic", strategicWaits);
+    printWaits("chaser", chaserWaits);
+
+    int neverServed = 0;
+    for (const auto& t : chasers) {
+        if (!t.everServed) neverServed++;
+    }
+    int unservedStrategic = 0;
+    for (const auto& t : strategic) {
+        if (!t.everServed) unservedStrategic++;
+    }
+    // 追击单位最后一次等待 (结束时还没送回的也算) 的最长帧数
+    int longestOpenWait = 0;
+    for (const auto& t : chasers) {
+        if (t.submittedAt >= 0) longestOpenWait = std::max(longestOpenWait, ticks - t.submittedAt);
+    }
+    std::printf("never served: chasers %d / %zu, strategic %d / %zu, still pending %zu, longest open chaser wait %d ticks\n",
+                neverServed, chasers.size(), unservedStrategic, strategic.size(), scheduler.pendingCount(), longestOpenWait);
+    return 0;
+}
@@ -0,0 +1,280 @@
+// 规模压测：同一个场景从 100 个单位一路加到 10 万个，每个规模跑固定帧数的无窗口战斗，
+// 报告 帧率 (ticks/s)、单帧耗时分布、每帧堆分配次数、堆内存峰值、各阶段每帧耗时，用来找扩展性的拐点
+//
+// 用法: scaling_bench [选项]
+//   --counts 100,1000,10000,100000   两队合计的单位数 (每队一半)
+//   --ticks <帧数>                   每个规模跑多少个逻辑帧 (默认 600，即 60 FPS 下 10 秒)
+//   --max-seconds <秒>               单个规模的墙钟上限，超时提前结束 (默认 120)
+//   --mix <配比>                     两队的兵种配比，如 knight:3,archers:1 (默认六个兵种平均)
+//   --mix-a / --mix-b <配比>         分别指定 TEAM_A / TEAM_B 的配比
+//   --layout formation|random        站位 (默认 formation)
+//   --size <行>x<列>                 固定地图大小 (默认按单位数自动放大)
+//   --map <文件>                     用地图文件 (所有规模共用)
+//   --obstacles <比例>               程序化地图上随机山脉的比例 (默认 0)
+//   --seed <种子>                    站位和地图的随机种子 (默认 1)
+//   --ai                             打开敌方 AI (默认关，只跑预先放好的单位)
+//   --json <文件>                    JSON 报告路径 (默认 scaling_report.json)
+//
+// 各阶段耗时需要定义 BATTLESIM_PROFILE (CMake 里这个目标默认打开)
+// 计时缓冲每个线程只保留最近的记录，单位很多、寻路调用很多时统计的是最后一段帧
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Game.h"
+#include "HeapStats.h"
+#include "MapFile.h"
+#include "Profiler.h"
+#include "Scenario.h"
+#include "Unit.h"
+
+namespace {
+    struct Options {
+        std::vector<int> counts{ 100, 1000, 10000, 100000 };
+        int ticks = 600;
+        double maxSeconds = 120.0;
+        ScenarioSpec spec;
+        int rows = 0, cols = 0;
+        std::string mapFile;
+        float obstacles = 0.f;
+        bool ai = false;
+        std::string jsonPath = "scaling_report.json";
+    };
+
+    struct PhaseRow {
+        double msPerTick; // 总耗时 / 统计到的帧数
+        double p50, p99;
+    };
+
+    struct RunResult {
+        int units = 0;
+        int rows = 0, cols = 0;
+        int ticks = 0;
+        double seconds = 0;
+        double tickP50 = 0, tickP99 = 0, tickMax = 0; // 毫秒
+        double allocsMean = 0;
+        std::uint64_t allocsMax = 0;
+        std::uint64_t peakHeap = 0;
+        std::size_t aliveAtEnd = 0;
+        std::size_t profiledTicks = 0;
+        std::map<std::string, PhaseRow> phases;
+    };
+
+    bool parseArgs(int argc, char* argv[], Options& opt) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--ai") {
+                opt.ai = true;
+            } else if (!hasValue) {
+                std::fprintf(stderr, "missing value for %s\n", arg.c_str());
+                return false;
+            } else if (arg == "--counts") {
+                opt.counts.clear();
+                std::istringstream ss(argv[++i]);
+                std::string item;
+                while (std::getline(ss, item, ',')) {
+                    if (std::atoi(item.c_str()) > 0) opt.counts.push_back(std::atoi(item.c_str()));
+                }
+            } else if (arg == "--ticks") {
+                opt.ticks = std::max(1, std::atoi(argv[++i]));
+            } else if (arg == "--max-seconds") {
+                opt.maxSeconds = std::atof(argv[++i]);
+            } else if (arg == "--mix") {
+                if (!Scenario::parseMix(argv[++i], opt.spec.mix[TEAM_A])) return false;
+                opt.spec.mix[TEAM_B] = opt.spec.mix[TEAM_A];
+            } else if (arg == "--mix-a") {
+                if (!Scenario::parseMix(argv[++i], opt.spec.mix[TEAM_A])) return false;
+            } else if (arg == "--mix-b") {
+                if (!Scenario::parseMix(argv[++i], opt.spec.mix[TEAM_B])) return false;
+            } else if (arg == "--layout") {
+                if (!Scenario::parseLayout(argv[++i], opt.spec.layout)) return false;
+            } else if (arg == "--size") {
+                if (std::sscanf(argv[++i], "%dx%d", &opt.rows, &opt.cols) != 2) return false;
+            } else if (arg == "--map") {
+                opt.mapFile = argv[++i];
+            } else if (arg == "--obstacles") {
+                opt.obstacles = static_cast<float>(std::atof(argv[++i]));
+            } else if (arg == "--seed") {
+                opt.spec.seed = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+            } else if (arg == "--json") {
+                opt.jsonPath = argv[++i];
+            } else {
+                std::fprintf(stderr, "unknown option %s\n", arg.c_str());
+                return false;
+            }
+        }
+        return !opt.counts.empty();
+    }
+
+    bool buildMap(const Options& opt, int units, MapData& map) {
+        if (!opt.mapFile.empty()) return MapFile::load(opt.mapFile, map);
+        int rows = opt.rows, cols = opt.cols;
+        if (rows <= 0 || cols <= 0) Scenario::fitMapSize(units, rows, cols);
+        return MapFile::generate(rows, cols, map, opt.obstacles, opt.spec.seed);
+    }
+
+    double percentile(std::vector<double>& sorted, double q) {
+        return sorted[static_cast<std::size_t>(q * (sorted.size() - 1) + 0.5)];
+    }
+
+    bool runOne(const Options& opt, int units, RunResult& out) {
+        HeapStats::resetPeak();
+
+        MapData map;
+        if (!buildMap(opt, units, map)) return false;
+        Game game(std::move(map), true);
+        game.setAIEnabled(opt.ai);
+
+        ScenarioSpec spec = opt.spec;
+        spec.unitsPerTeam[TEAM_A] = units / 2;
+        spec.unitsPerTeam[TEAM_B] = units - units / 2;
+        Scenario::populate(game, spec);
+
+        out.units = units;
+        out.rows = game.map().tiles.rows();
+        out.cols = game.map().tiles.cols();
+
+        // 固定帧长 (和逻辑线程的目标帧率一致)，逐帧计时
+        const float dt = 1.f / 60.f;
+        std::vector<double> tickMs;
+        tickMs.reserve(opt.ticks);
+        std::uint64_t allocsTotal = 0;
+        const std::uint64_t profileStart = Profiler::nowNs();
+        auto runStart = std::chrono::steady_clock::now();
+        for (int t = 0; t < opt.ticks; ++t) {
+            auto t0 = std::chrono::steady_clock::now();
+            game.step(dt);
+            auto t1 = std::chrono::steady_clock::now();
+            tickMs.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+            allocsTotal += game.lastTickAllocations();
+            out.allocsMax = std::max(out.allocsMax, game.lastTickAllocations());
+            if (std::chrono::duration<double>(t1 - runStart).count() > opt.maxSeconds) break;
+        }
+        out.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - runStart).count();
+        out.ticks = static_cast<int>(tickMs.size());
+        out.allocsMean = static_cast<double>(allocsTotal) / out.ticks;
+        std::sort(tickMs.begin(), tickMs.end());
+        out.tickP50 = percentile(tickMs, 0.50);
+        out.tickP99 = percentile(tickMs, 0.99);
+        out.tickMax = tickMs.back();
+        out.peakHeap = HeapStats::peakLiveBytes();
+        out.aliveAtEnd = game.unitCount();
+
+#ifdef BATTLESIM_PROFILE
+        // 只看逻辑帧的各阶段；"update" 的次数就是实际统计到的帧数
+        std::vector<Profiler::PhaseStats> stats = Profiler::summarize(profileStart);
+        for (const auto& s : stats) {
+            if (s.name == "update") out.profiledTicks = s.calls;
+        }
+        for (const auto& s : stats) {
+            if (s.name.compare(0, 7, "update.") != 0) continue;
+            out.phases[s.name] = PhaseRow{ out.profiledTicks ? s.total / out.profiledTicks : 0.0, s.p50, s.p99 };
+        }
+#else
+        (void)profileStart;
+#endif
+        return true;
+    }
+
+    void printRuns(const std::vector<RunResult>& runs) {
+        std::printf("\n%9s %11s %6s %10s %9s %9s %9s %12s %10s %10s\n", "units", "map", "ticks", "ticks/s",
+                    "p50 ms", "p99 ms", "max ms", "allocs/tick", "peak heap", "alive");
+        for (const RunResult& r : runs) {
+            char map[32];
+            std::snprintf(map, sizeof(map), "%dx%d", r.rows, r.cols);
+            std::printf("%9d %11s %6d %10.1f %9.3f %9.3f %9.3f %12.2f %7.1f MB %10zu\n", r.units, map, r.ticks,
+                        r.ticks / r.seconds, r.tickP50, r.tickP99, r.tickMax, r.allocsMean,
+                        r.peakHeap / (1024.0 * 1024.0), r.aliveAtEnd);
+        }
+
+        // 各阶段每帧耗时：行 = 阶段，列 = 规模，一眼能看出哪一段随规模陡增
+        std::vector<std::string> names;
+        for (const RunResult& r : runs) {
+            for (const auto& p : r.phases) {
+                if (std::find(names.begin(), names.end(), p.first) == names.end()) names.push_back(p.first);
+            }
+        }
+        if (names.empty()) return;
+        std::printf("\nms per tick by phase\n%-20s", "phase");
+        for (const RunResult& r : runs) std::printf(" %10d", r.units);
+        std::printf("\n");
+        for (const std::string& name : names) {
+            std::printf("%-20s", name.c_str());
+            for (const RunResult& r : runs) {
+                auto it = r.phases.find(name);
+                if (it == r.phases.end()) std::printf(" %10s", "-");
+                else std::printf(" %10.3f", it->second.msPerTick);
+            }
+            std::printf("\n");
+        }
+        for (const RunResult& r : runs) {
+            if (r.profiledTicks < static_cast<std::size_t>(r.ticks)) {
+                std::printf("(%d units: phase times cover the last %zu of %d ticks)\n", r.units, r.profiledTicks, r.ticks);
+            }
+        }
+    }
+
+    bool writeJson(const Options& opt, const std::vector<RunResult>& runs) {
+        std::FILE* f = std::fopen(opt.jsonPath.c_str(), "w");
+        if (!f) return false;
+        std::fprintf(f, "{\n  \"config\": {\"ticks\": %d, \"layout\": \"%s\", \"seed\": %u, \"ai\": %s},\n  \"runs\": [\n",
+                     opt.ticks, opt.spec.layout == ScenarioLayout::RANDOM ? "random" : "formation", opt.spec.seed,
+                     opt.ai ? "true" : "false");
+        for (std::size_t i = 0; i < runs.size(); ++i) {
+            const RunResult& r = runs[i];
+            std::fprintf(f, "    {\"units\": %d, \"rows\": %d, \"cols\": %d, \"ticks\": %d, \"seconds\": %.3f, "
+                            "\"ticks_per_second\": %.2f, \"tick_ms\": {\"p50\": %.4f, \"p99\": %.4f, \"max\": %.4f}, "
+                            "\"allocs_per_tick\": {\"mean\": %.3f, \"max\": %llu}, \"peak_heap_bytes\": %llu, "
+                            "\"alive_at_end\": %zu, \"profiled_ticks\": %zu, \"phases\": {",
+                         r.units, r.rows, r.cols, r.ticks, r.seconds, r.ticks / r.seconds, r.tickP50, r.tickP99, r.tickMax,
+                         r.allocsMean, static_cast<unsigned long long>(r.allocsMax),
+                         static_cast<unsigned long long>(r.peakHeap), r.aliveAtEnd, r.profiledTicks);
+            bool first = true;
+            for (const auto& p : r.phases) {
+                std::fprintf(f, "%s\"%s\": {\"ms_per_tick\": %.4f, \"p50\": %.4f, \"p99\": %.4f}", first ? "" : ", ",
+                             p.first.c_str(), p.second.msPerTick, p.second.p50, p.second.p99);
+                first = false;
+            }
+            std::fprintf(f, "}}%s\n", i + 1 < runs.size() ? "," : "");
+        }
+        std::fprintf(f, "  ]\n}\n");
+        bool ok = std::ferror(f) == 0;
+        std::fclose(f);
+        return ok;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        std::fprintf(stderr, "Usage: scaling_bench [--counts N,N,...] [--ticks T] [--max-seconds S] [--mix SPEC] "
+                             "[--mix-a SPEC] [--mix-b SPEC] [--layout formation|random] [--size ROWSxCOLS] "
+                             "[--map FILE] [--obstacles P] [--seed N] [--ai] [--json FILE]\n");
+        return 1;
+    }
+
+    std::vector<RunResult> runs;
+    for (int units : opt.counts) {
+        RunResult r;
+        std::printf("running %d units...\n", units);
+        std::fflush(stdout);
+        if (!runOne(opt, units, r)) {
+            std::fprintf(stderr, "failed to build map for %d units\n", units);
+            return 1;
+        }
+        runs.push_back(r);
+    }
+
+    printRuns(runs);
+    if (!writeJson(opt, runs)) {
+        std::fprintf(stderr, "cannot write %s\n", opt.jsonPath.c_str());
+        return 1;
+    }
+    std::printf("\nwrote %s\n", opt.jsonPath.c_str());
+    return 0;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <vector>
+#include "SpatialGrid.h"
+
+class Unit; // 前向声明
+
+// 休眠/唤醒调度
+// 警戒范围内没有敌人的单位 (以及塔) 进入休眠：不再每帧扫描周围格子找敌人。
+// 休眠时在 SpatialGrid 上登记一片监视块 (警戒范围 + 休眠期间最多能走的距离)，
+// 下面两种情况会唤醒它：
+//   1. 网格重建时有敌方单位落进这片监视块 (网格报警)
+//   2. 到了最长休眠时间 (移动中的单位会走出监视范围，塔则是兜底)
+// 醒来后单位照常索敌，还是没有敌人就再睡。只在逻辑线程使用
+class ActivityScheduler {
+public:
+    // 单位在本帧 update 里请求休眠后调用
+    void sleep(Unit* unit, SpatialGrid& grid);
+
+    // 处理网格警报和到期的休眠者 (每帧单位 update 之前调用)
+    void update(float dt, SpatialGrid& grid);
+
+    // 单位被删除前调用
+    void cancel(Unit* unit, SpatialGrid& grid);
+
+    // 统计
+    std::size_t sleeperCount() const { return m_sleepers.size(); }
+    int lastWakeCount() const { return m_lastWakeCount; }
+
+private:
+    struct Sleeper {
+        Unit* unit;
+        int team;
+        int r0, c0, r1, c1; // 监视块范围 (块坐标，闭区间)
+        double wakeAt;      // 最迟唤醒时间
+    };
+
+    void wake(std::size_t index, SpatialGrid& grid);
+
+    std::vector<Sleeper> m_sleepers;
+    double m_time = 0.0;
+    int m_lastWakeCount = 0;
+};
@@ -0,0 +1,81 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "AssetManifest.h"
+#include "MappedFile.h"
+
+// 打包资源文件 (assets.pak) 格式
+// 由离线打包工具 asset_packer 生成，运行时整体 mmap，直接从映射内存创建纹理/音效
+//
+// [PakHeader][PakEntry x entryCount][名字字符串表][数据区 (16 字节对齐)]
+// - 纹理: 预解码的 RGBA8 像素        param0 = 宽, param1 = 高
+// - 音效: 预解码的 16 位 PCM 采样     param0 = 声道数, param1 = 采样率, param2 = 采样数
+// - 字体: 原始 TTF 字节 (FreeType 直接从内存读取)
+// 条目按名字排序，查找用二分
+
+const char PAK_MAGIC[4] = { 'B', 'P', 'A', 'K' };
+const std::uint32_t PAK_VERSION = 1;
+const std::uint64_t PAK_DATA_ALIGN = 16;
+
+struct PakHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t entryCount;
+    std::uint32_t stringTableSize;
+    std::uint64_t indexOffset;   // PakEntry 数组的位置
+    std::uint64_t stringsOffset; // 名字字符串表的位置
+};
+
+struct PakEntry {
+    std::uint32_t nameOffset;    // 在字符串表中的偏移
+    std::uint32_t nameLength;
+    std::uint32_t kind;          // AssetKind
+    std::uint32_t param0;
+    std::uint32_t param1;
+    std::uint32_t reserved;
+    std::uint64_t param2;
+    std::uint64_t dataOffset;    // 相对文件开头
+    std::uint64_t dataSize;
+};
+
+// 运行时读取：mmap 整个包，按名字查条目
+class AssetArchive {
+public:
+    bool open(const std::string& fileName);
+    bool isOpen() const { return m_file.isOpen(); }
+
+    // 找不到返回 nullptr (只在加载阶段调用，不在热路径上)
+    const PakEntry* find(const std::string& name) const;
+
+    // 条目数据在映射内存中的指针
+    const std::uint8_t* data(const PakEntry& entry) const { return m_file.data() + entry.dataOffset; }
+
+private:
+    MappedFile m_file;
+    const PakEntry* m_entries = nullptr;
+    std::uint32_t m_entryCount = 0;
+    const char* m_strings = nullptr;
+
+    std::string_view entryName(const PakEntry& entry) const {
+        return std::string_view(m_strings + entry.nameOffset, entry.nameLength);
+    }
+};
+
+// 离线写入：打包工具收集所有条目后一次性写出
+class AssetArchiveWriter {
+public:
+    void add(const std::string& name, AssetKind kind, const void* data, std::uint64_t size,
+             std::uint32_t param0 = 0, std::uint32_t param1 = 0, std::uint64_t param2 = 0);
+
+    bool write(const std::string& fileName) const;
+
+private:
+    struct Item {
+        std::string name;
+        PakEntry entry;
+        std::vector<std::uint8_t> bytes;
+    };
+    std::vector<Item> m_items;
+};
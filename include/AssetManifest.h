@@ -0,0 +1,99 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// 资源清单：项目中所有已知资源的句柄、别名、路径
+// 用 X-Macro 写一次，同时生成：
+//   1. 编译期的整数句柄 (TextureId / SoundId / FontId)，运行时查找就是数组下标
+//   2. ASSET_MANIFEST 表，供加载器和打包工具遍历
+// 新增资源只需要在下面对应的列表里加一行
+//
+// X(句柄, 别名, 文件路径, 是否第一帧就需要)
+
+#define BATTLESIM_TEXTURES(X) \
+    /* 1. 地图与UI */ \
+    X(BACKGROUND,  "background",  "assets/textures/Background.png",     true) \
+    X(MAIN_BG,     "main_bg",     "assets/textures/mainBackground.png", true) /* 可能用于菜单 */ \
+    X(UI_HEART,    "ui_heart",    "assets/textures/heart.png",          true) \
+    X(UI_ELIXIR,   "ui_elixir",   "assets/textures/elixirCost.png",     true) \
+    X(UI_ADD,      "ui_add",      "assets/textures/addCard.png",        true) \
+    X(UI_REMOVE,   "ui_remove",   "assets/textures/removeCard.png",     true) \
+    X(VFX_DAMAGED, "vfx_damaged", "assets/textures/damaged_area.png",   true) \
+    X(UI_CROWN,    "ui_crown",    "assets/textures/life_bar_crown.png", true) \
+    /* 2. 投射物 */ \
+    X(BULLET,      "bullet",      "assets/textures/bullet.png",             true) \
+    X(ARROW_SHEET, "arrow_sheet", "assets/textures/arrows_spritesheet.png", true) /* 箭矢动画 */ \
+    /* 3. 士兵 (Spritesheets - 动态图) */ \
+    X(UNIT_ARCHERS,    "unit_archers",    "assets/textures/archers_spritesheet.png",    true) \
+    X(UNIT_DARTGOBLIN, "unit_dartgoblin", "assets/textures/dartGoblin_spritesheet.png", true) \
+    X(UNIT_GIANT,      "unit_giant",      "assets/textures/giant_spritesheet.png",      true) \
+    X(UNIT_KNIGHT,     "unit_knight",     "assets/textures/knight_spritesheet.png",     true) \
+    X(UNIT_PEKKA,      "unit_pekka",      "assets/textures/pekka_spritesheet.png",      true) \
+    X(UNIT_VALKYRIE,   "unit_valkyrie",   "assets/textures/valkyrie_spritesheet.png",   true) \
+    /* 4. 士兵 (Static - 卡牌图标/头像) */ \
+    X(ICON_ARCHERS,    "icon_archers",    "assets/textures/archers.png",     true) \
+    X(ICON_DARTGOBLIN, "icon_dartgoblin", "assets/textures/dart_goblin.png", true) \
+    X(ICON_GIANT,      "icon_giant",      "assets/textures/giant.png",       true) \
+    X(ICON_KNIGHT,     "icon_knight",     "assets/textures/knight.png",      true) \
+    X(ICON_PEKKA,      "icon_pekka",      "assets/textures/pekka.png",       true) \
+    X(ICON_VALKYRIE,   "icon_valkyrie",   "assets/textures/valkyrie.png",    true)
+
+// 音频第一帧用不到，后台加载
+#define BATTLESIM_SOUNDS(X) \
+    /* 部署 (Deploy) */ \
+    X(DEPLOY_ARCHERS,    "sfx_deploy_archers",    "assets/audio/archers_deploy_sound.ogg",    false) \
+    X(DEPLOY_DARTGOBLIN, "sfx_deploy_dartgoblin", "assets/audio/dartgoblin_deploy_sound.ogg", false) \
+    X(DEPLOY_GIANT,      "sfx_deploy_giant",      "assets/audio/giant_deploy_sound.ogg",      false) \
+    X(DEPLOY_KNIGHT,     "sfx_deploy_knight",     "assets/audio/knight_deploy_sound.ogg",     false) \
+    X(DEPLOY_PEKKA,      "sfx_deploy_pekka",      "assets/audio/pekka_deploy_sound.ogg",      false) \
+    X(DEPLOY_VALKYRIE,   "sfx_deploy_valkyrie",   "assets/audio/valkyrie_deploy_sound.ogg",   false) \
+    /* 攻击/受击 (Hit) */ \
+    X(HIT_ARCHERS,    "sfx_hit_archers",    "assets/audio/archers_hit_sound.ogg",    false) \
+    X(HIT_DARTGOBLIN, "sfx_hit_dartgoblin", "assets/audio/dartgoblin_hit_sound.ogg", false) \
+    X(HIT_GIANT,      "sfx_hit_giant",      "assets/audio/giant_hit_sound.ogg",      false) \
+    X(HIT_KNIGHT,     "sfx_hit_knight",     "assets/audio/knight_hit_sound.ogg",     false) \
+    X(HIT_PEKKA,      "sfx_hit_pekka",      "assets/audio/pekka_hit_sound.ogg",      false) \
+    X(HIT_VALKYRIE,   "sfx_hit_valkyrie",   "assets/audio/valkyrie_hit_sound.ogg",   false)
+
+#define BATTLESIM_FONTS(X) \
+    X(MAIN, "main_font", "assets/fonts/Supercell_Magic_Regular.ttf", true)
+
+// --- 编译期句柄 ---
+#define BATTLESIM_ASSET_ID(id, name, path, critical) id,
+enum class TextureId : std::uint16_t { BATTLESIM_TEXTURES(BATTLESIM_ASSET_ID) COUNT };
+enum class SoundId   : std::uint16_t { BATTLESIM_SOUNDS(BATTLESIM_ASSET_ID) COUNT };
+enum class FontId    : std::uint16_t { BATTLESIM_FONTS(BATTLESIM_ASSET_ID) COUNT };
+#undef BATTLESIM_ASSET_ID
+
+const std::size_t TEXTURE_COUNT = static_cast<std::size_t>(TextureId::COUNT);
+const std::size_t SOUND_COUNT   = static_cast<std::size_t>(SoundId::COUNT);
+const std::size_t FONT_COUNT    = static_cast<std::size_t>(FontId::COUNT);
+
+// --- 清单表 (加载器/打包工具遍历用) ---
+enum class AssetKind {
+    TEXTURE,
+    SOUND,
+    FONT
+};
+
+struct AssetEntry {
+    const char* name;  // 别名 (打包文件里的键)
+    const char* path;  // 文件路径 (相对于可执行文件目录)
+    AssetKind kind;
+    std::uint16_t index; // 对应 TextureId / SoundId / FontId 的数值
+    bool critical;     // 第一帧就需要？(否则在后台慢慢加载)
+};
+
+#define BATTLESIM_TEXTURE_ENTRY(id, name, path, critical) { name, path, AssetKind::TEXTURE, static_cast<std::uint16_t>(TextureId::id), critical },
+#define BATTLESIM_SOUND_ENTRY(id, name, path, critical)   { name, path, AssetKind::SOUND,   static_cast<std::uint16_t>(SoundId::id),   critical },
+#define BATTLESIM_FONT_ENTRY(id, name, path, critical)    { name, path, AssetKind::FONT,    static_cast<std::uint16_t>(FontId::id),    critical },
+
+inline constexpr AssetEntry ASSET_MANIFEST[] = {
+    BATTLESIM_TEXTURES(BATTLESIM_TEXTURE_ENTRY)
+    BATTLESIM_FONTS(BATTLESIM_FONT_ENTRY)
+    BATTLESIM_SOUNDS(BATTLESIM_SOUND_ENTRY)
+};
+
+#undef BATTLESIM_TEXTURE_ENTRY
+#undef BATTLESIM_SOUND_ENTRY
+#undef BATTLESIM_FONT_ENTRY
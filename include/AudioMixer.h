@@ -0,0 +1,85 @@
+#pragma once
+#include <SFML/Audio.hpp>
+#include <SFML/System.hpp>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include "AssetManifest.h"
+#include "LockFreeQueue.h"
+
+// 音效优先级：声部不够时，低优先级的先被抢占
+enum class SoundPriority : std::uint8_t {
+    LOW = 0,   // 攻击/受击，战斗中大量重复
+    HIGH = 1   // 部署，玩家操作的直接反馈
+};
+
+// 逻辑线程投递的音效事件
+struct SoundEvent {
+    SoundId id;
+    SoundPriority priority;
+    sf::Vector2f position; // 世界坐标 (像素)
+};
+
+// 单例音频混音服务
+// - 固定数量的 sf::Sound 声部 (OpenAL 源数量有限，不再每个单位两个)
+// - 逻辑线程只往无锁队列里投事件，音频线程统一取出、合并、分配声部
+// - 同一帧内相同的音效合并成一次播放 (音量随次数略微增大)
+// - 声部用满时按 优先级 → 距离 抢占
+class AudioMixer {
+public:
+    static AudioMixer& getInstance();
+
+    // 禁止拷贝
+    AudioMixer(const AudioMixer&) = delete;
+    void operator=(const AudioMixer&) = delete;
+
+    // 启动/停止音频线程
+    void start();
+    void stop();
+
+    // 任何线程都可以调用，无锁；队列满时直接丢弃 (丢一个音效无所谓)
+    void post(SoundId id, sf::Vector2f position, SoundPriority priority);
+
+    // 听者位置 (摄像机中心)，用于距离衰减和抢占判断
+    void setListener(sf::Vector2f position);
+
+    // 固定声部数
+    static const int VOICE_COUNT = 32;
+    // 每帧最多新开的声部数 (防止一帧内几十个音效同时起播)
+    static const int MAX_STARTS_PER_FRAME = 8;
+
+private:
+    AudioMixer();
+    ~AudioMixer();
+
+    struct Voice {
+        sf::Sound sound;
+        SoundPriority priority;
+        sf::Vector2f position;
+    };
+
+    // 同一帧内合并后的待播放音效
+    struct PendingSound {
+        SoundEvent event;
+        int count;        // 合并了多少个相同事件
+        float distance;   // 到听者的距离
+    };
+
+    std::array<Voice, VOICE_COUNT> m_voices;
+    LockFreeQueue<SoundEvent, 1024> m_events;
+
+    std::thread m_thread;
+    std::atomic<bool> m_running;
+    std::atomic<float> m_listenerX;
+    std::atomic<float> m_listenerY;
+
+    // 音频线程主循环
+    void audioLoop();
+    // 取出本帧所有事件，合并后分配声部
+    void mixFrame();
+    // 找一个可用声部，必要时抢占；没有可抢的返回 nullptr
+    Voice* acquireVoice(const PendingSound& pending, sf::Vector2f listener);
+
+    float distanceTo(sf::Vector2f a, sf::Vector2f b) const;
+};
@@ -0,0 +1,55 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+
+// 细节层级 (Level Of Detail)
+// 缩得越远，画得越简单
+enum class LodLevel {
+    FULL,     // 完整绘制：动画精灵 + 血条/皇冠
+    NO_HUD,   // 只画精灵，不画单位血条
+    IMPOSTOR  // 用阵营色小方块代替精灵 (一次 draw call 批量绘制)
+};
+
+// 可滚动、可缩放的战场摄像机
+// 封装 sf::View，负责把地图区域映射到窗口上方 (底部留给 UI)
+class Camera {
+public:
+    Camera();
+
+    // worldSize: 整张地图的像素尺寸
+    // screenSize: 地图区域在窗口中的像素尺寸 (不含 UI)
+    // windowSize: 整个窗口的像素尺寸 (用于计算 viewport 比例)
+    void init(sf::Vector2f worldSize, sf::Vector2f screenSize, sf::Vector2u windowSize);
+
+    // 键盘平移 (WASD / 方向键)，每帧调用
+    void update(float dt);
+
+    // 以某个世界坐标为锚点缩放 (鼠标滚轮)，factor > 1 表示拉远
+    void zoomAt(float factor, sf::Vector2f worldAnchor);
+
+    // 按屏幕像素平移 (鼠标拖拽)
+    void panPixels(sf::Vector2f pixelDelta);
+
+    // 重置为默认视角 (Home 键)
+    void reset();
+
+    const sf::View& getView() const { return m_view; }
+
+    // 当前可见的世界矩形 (用于视锥裁剪)
+    sf::FloatRect getVisibleRect() const;
+
+    // 缩放倍率：1 = 一个世界像素对应一个屏幕像素，越大看得越远
+    float getZoom() const { return m_zoom; }
+
+    LodLevel getLod() const;
+
+private:
+    sf::View m_view;
+    sf::Vector2f m_worldSize;
+    sf::Vector2f m_screenSize;
+    float m_zoom;
+    float m_minZoom;
+    float m_maxZoom;
+
+    // 把视图中心限制在地图内，防止拖出地图
+    void clampCenter();
+};
@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "UnitHandle.h"
+
+class Unit; // 前向声明
+
+// 一次伤害提交
+struct DamageEvent {
+    UnitHandle target;
+    float amount; // 护甲减免前的伤害
+};
+
+// 延迟伤害缓冲
+// 原来攻击方直接改目标的血量和颜色，结果依赖单位的更新顺序 (先更新的先打死对方)，
+// 也没法并行更新。现在攻击、范围伤害、子弹命中都只提交事件：
+//   submit   任何线程调用，写进调用线程自己的缓冲区，不加锁
+//   resolve  逻辑帧末尾在逻辑线程调用一次 (所有提交方都结束之后)：
+//            按目标汇总 (每次命中单独算护甲)，每个目标只写一次血量和受击反馈
+// 同一帧内的伤害同时生效，和提交顺序无关
+class DamageBuffer {
+public:
+    explicit DamageBuffer(const UnitHandleTable& units);
+
+    DamageBuffer(const DamageBuffer&) = delete;
+    void operator=(const DamageBuffer&) = delete;
+
+    void submit(const Unit* target, float amount);
+
+    // 结算并清空所有缓冲区，返回本帧新倒下的单位数
+    int resolve();
+
+    // 单位句柄表 (攻击方用它解析锁定目标的句柄)
+    const UnitHandleTable& units() const { return m_units; }
+
+    // 统计 (上一次 resolve)
+    std::size_t lastEventCount() const { return m_lastEvents; }
+    std::size_t lastTargetCount() const { return m_lastTargets; }
+
+private:
+    // 调用线程的缓冲区 (第一次调用时登记)
+    std::vector<DamageEvent>& local();
+
+    const UnitHandleTable& m_units;
+    const std::uint64_t m_serial; // 区分实例，线程缓存用
+
+    // 每个线程一个缓冲区，按线程 id 登记
+    // 线程缓存只记一个实例，几个 DamageBuffer 在同一线程交替使用时会反复错过缓存，
+    // 所以错过时先按线程 id 找已有的缓冲区，找不到才新建 (否则缓冲区只增不减)
+    struct ThreadBuffer {
+        std::thread::id thread;
+        std::unique_ptr<std::vector<DamageEvent>> events;
+    };
+    std::mutex m_registerMutex; // 只在线程缓存没命中时加锁
+    std::vector<ThreadBuffer> m_buffers;
+
+    // 按句柄槽位下标累计 (容量复用)
+    std::vector<float> m_total;
+    std::vector<std::uint8_t> m_touched;
+    struct Touched {
+        std::uint32_t index;
+        Unit* unit;
+    };
+    std::vector<Touched> m_touchedList;
+
+    std::size_t m_lastEvents = 0;
+    std::size_t m_lastTargets = 0;
+};
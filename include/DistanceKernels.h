@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <SFML/System.hpp>
+
+class Unit; // 前向声明
+
+// 批量距离计算
+// 索敌和范围伤害原来是一个候选一个 sqrt；这里先把候选单位的坐标收集成 SoA 数组
+// (x[] / y[] 分开存)，再一次算 8 个候选的平方距离：
+//   nearest      半径内平方距离最小的候选 (带掩码的 argmin)
+//   withinRadius 半径内的候选下标 (由比较掩码生成)
+// 全程比较平方距离，不开方。
+// 三套实现：标量 / SSE (4 宽，x86-64 必有) / AVX2 (8 宽)，启动时按 CPU 选择最快的一套
+namespace DistanceKernels {
+
+enum class Isa { SCALAR, SSE, AVX2 };
+
+// 当前使用的指令集 / 强制切换 (基准测试用；不支持的会退回可用的最高一档)
+Isa activeIsa();
+void setIsa(Isa isa);
+const char* isaName(Isa isa);
+
+// 半径内 (平方距离 <= maxDist2) 最近的候选下标，没有返回 -1；outDist2 可为空
+int nearest(const float* xs, const float* ys, int count, float px, float py, float maxDist2, float* outDist2 = nullptr);
+
+// 把半径内候选的下标写进 outIndices (容量至少 count)，返回个数
+int withinRadius(const float* xs, const float* ys, int count, float px, float py, float radius2, int* outIndices);
+
+} // namespace DistanceKernels
+
+// 一批候选单位 (SoA)，按需增长，clear 后复用容量
+struct CandidateBlock {
+    std::vector<float> xs;
+    std::vector<float> ys;
+    std::vector<Unit*> units;
+    std::vector<int> hits; // within() 的输出
+
+    void clear() { xs.clear(); ys.clear(); units.clear(); }
+    int size() const { return static_cast<int>(units.size()); }
+
+    void push(Unit* unit, sf::Vector2f pos) {
+        xs.push_back(pos.x);
+        ys.push_back(pos.y);
+        units.push_back(unit);
+    }
+
+    // 半径内最近的候选，没有返回 nullptr
+    Unit* nearest(sf::Vector2f from, float maxDist) const {
+        int i = DistanceKernels::nearest(xs.data(), ys.data(), size(), from.x, from.y, maxDist * maxDist);
+        return i >= 0 ? units[i] : nullptr;
+    }
+
+    // 半径内候选的下标 (指向 units)，按收集顺序
+    const std::vector<int>& within(sf::Vector2f from, float radius) {
+        hits.resize(units.size());
+        hits.resize(DistanceKernels::withinRadius(xs.data(), ys.data(), size(), from.x, from.y, radius * radius, hits.data()));
+        return hits;
+    }
+};
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class Unit; // 前向声明
+
+// 战场事件类型
+enum class GameEventType : std::uint8_t {
+    TOWER_DESTROYED, // 塔被摧毁 (unit 是那座塔)
+    UNIT_SPAWNED,    // 单位或塔被放上战场
+    UNIT_DIED,       // 非建筑单位死亡
+    COUNT
+};
+
+// 事件在单位被删除之前同步派发，处理函数里 unit 仍然有效
+struct GameEvent {
+    GameEventType type;
+    Unit* unit;
+};
+
+// 事件总线：同步派发，按事件类型分桶
+// 谁关心什么事件就订阅什么，发布方不需要知道有哪些订阅者
+// 只在逻辑线程使用
+class EventBus {
+public:
+    using Handler = std::function<void(const GameEvent&)>;
+
+    void subscribe(GameEventType type, Handler handler) {
+        m_handlers[static_cast<std::size_t>(type)].push_back(std::move(handler));
+    }
+
+    void publish(const GameEvent& event) const {
+        for (const auto& handler : m_handlers[static_cast<std::size_t>(event.type)]) {
+            handler(event);
+        }
+    }
+
+private:
+    std::vector<Handler> m_handlers[static_cast<std::size_t>(GameEventType::COUNT)];
+};
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+// 逐帧线性分配器 (bump allocator)，可以直接当 std::pmr 容器的内存资源
+// 一帧里的临时容器 (寻路开放列表、AI 的候选列表……) 都从一整块预留缓冲里顺序切：
+// 分配只是移动一下指针，释放什么都不做，帧末 reset() 一次性全部收回
+// 这一帧用超了，就临时向堆要溢出块；reset() 时把主缓冲扩到本帧的峰值，下一帧起不再溢出
+// 所以稳定运行时一次堆分配都没有
+//
+// 每个线程一个 (forThread)，不加锁。从它分配的东西活不过 reset()：
+// 需要跨帧保留的数据 (空间网格、单位路径) 不能放在这里
+class FrameArena : public std::pmr::memory_resource {
+public:
+    static const std::size_t DEFAULT_CAPACITY = 256 * 1024;
+
+    explicit FrameArena(std::size_t capacity = DEFAULT_CAPACITY);
+    ~FrameArena() override;
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // 当前线程的分配器
+    static FrameArena& forThread();
+
+    // 收回全部分配 (帧末调用)；本帧溢出过就按峰值扩容主缓冲
+    void reset();
+
+    // 作用域标记：析构时退回到构造时的位置 (后进先出)
+    // 函数内部的临时容器用它及时归还，不用等到帧末 (峰值照记，扩容仍在 reset() 里做)
+    class Scope {
+    public:
+        explicit Scope(FrameArena& arena)
+            : m_arena(arena), m_offset(arena.m_offset), m_overflowCount(arena.m_overflow.size()) {}
+        ~Scope() { m_arena.rewind(m_offset, m_overflowCount); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        FrameArena& m_arena;
+        std::size_t m_offset;
+        std::size_t m_overflowCount;
+    };
+
+    // 统计
+    std::size_t capacity() const { return m_capacity; }
+    std::size_t used() const { return m_offset + m_overflowBytes; }
+    std::size_t peak() const { return m_peak; }           // 上次 reset 以来的峰值
+    std::uint64_t overflows() const { return m_overflows; } // 累计溢出次数
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+    void rewind(std::size_t offset, std::size_t overflowCount);
+    void releaseOverflow(std::size_t keep);
+
+    struct Overflow {
+        void* data;
+        std::size_t bytes;
+        std::size_t alignment;
+    };
+
+    std::byte* m_buffer;
+    std::size_t m_capacity;
+    std::size_t m_offset;
+    std::vector<Overflow> m_overflow; // 本帧的溢出块 (容量复用)
+    std::size_t m_overflowBytes;
+    std::size_t m_peak;
+    std::uint64_t m_overflows;
+};
@@ -4,21 +4,21 @@
 #include <thread> 
 #include <mutex> 
 #include <atomic> // 用于线程安全的 bool
-#include "ObjectPool.h"
+#include "Camera.h"
+#include "TileMap.h"
+#include "SpatialGrid.h"
+#include "MapFile.h"
+#include "PathScheduler.h"
+#include "EventBus.h"
+#include "TowerRegistry.h"
+#include "ActivityScheduler.h"
+#include "UnitHandle.h"
+#include "ProjectileSystem.h"
+#include "DamageBuffer.h"
 
 // 前向声明
 class Unit; 
-class Projectile;
-
-// 地形类型枚举
-enum TileType {
-    GROUND = 0, // 平地 (草绿)
-    RIVER,      // 河流 (蓝色)
-    BRIDGE,     // 桥梁 (木色)
-    MOUNTAIN,   // 山脉 (灰色)
-    BASE_A,     // 甲方基地 (红色)
-    BASE_B      // 乙方基地 (蓝色)
-};
+class Tower;
 
 // 兵种类型枚举
 enum class UnitType {
@@ -50,44 +50,99 @@ struct Card {
 class Game {
 public:
 
-    Game();
+    // 地图由调用方载入或生成 (见 MapFile)，尺寸在运行时决定
+    // headless = true 时不建窗口、不加载资源、不启动音频，只有战斗逻辑：
+    // 由调用方用 step() 逐帧推进 (基准测试、压力测试用)，不能调用 run()
+    explicit Game(MapData map, bool headless = false);
     ~Game();
     
     // 运行游戏主循环
     void run();
 
-    // 静态常量：定义地图大小
-    static const int TILE_SIZE = 40; // 每个格子的像素大小
-    static const int ROWS = 19;      // 行
-    static const int COLS = 21;      // 列
+    // 推进一个逻辑帧 (无窗口模式用，和逻辑线程里的 update 完全相同)
+    void step(float dt) { update(dt); }
+
+    // 在世界坐标 (x, y) 放一个单位 (逻辑线程或无窗口模式下调用)
+    void spawnUnit(UnitType type, float x, float y, int team);
+
+    // 关掉敌方 AI (压测时只跑预先放好的单位)
+    void setAIEnabled(bool enabled) { m_aiEnabled = enabled; }
+
+    // 场上的单位和塔 (含已倒下、等待本帧清理的)
+    std::size_t unitCount() const { return m_units.size(); }
+    std::size_t projectileCount() const { return m_projectiles.size(); }
+    const MapData& map() const { return m_map; }
+
+    // 每个格子的像素大小 (渲染和世界坐标换算用，不随地图变化)
+    static const int TILE_SIZE = 40;
+    // 默认地图文件 (相对于可执行文件目录)
+    static constexpr const char* DEFAULT_MAP_FILE = "assets/maps/default.map";
+    // 默认地图大小 (地图文件缺失时程序化生成)
+    static const int DEFAULT_ROWS = 19;
+    static const int DEFAULT_COLS = 21;
 
     // UI 区域高度
     static const int UI_HEIGHT = 160; // 底部预留给卡牌和圣水条的高度
 
+    // 地图显示区域的最大像素尺寸 (大地图靠摄像机滚动/缩放查看)
+    static const int MAX_VIEW_WIDTH = 1280;
+    static const int MAX_VIEW_HEIGHT = 800;
+
     // 设置游戏难度
     void setDifficulty(Difficulty level);
 
+    // 上一个逻辑帧在逻辑线程上的堆分配次数
+    std::uint64_t lastTickAllocations() const { return m_heapTickAllocs; }
+
 private:
     // SFML 窗口
     sf::RenderWindow m_window;
 
-    // 地图数据：二维数组
-    // 使用 vector<vector<int>> 方便管理，存储的是 TileType 的整数值
-    std::vector<std::vector<int>> m_mapData;
+    // 地图数据：地形 (一维 uint8_t + 可通行位图)、塔位、部署区、进攻路线
+    MapData m_map;
 
     // --- 空间划分优化 ---
-    // 一维数组模拟二维网格，索引 = row * COLS + col
-    // 每个格子里存储该格子内的单位列表
-    std::vector<std::vector<Unit*>> m_spatialGrid;
+    // 与地图同尺寸，每个格子里存储该格子内的单位
+    SpatialGrid m_spatialGrid;
+    // 有单位的格子平均至少这么多个单位时，重建后才按格子重排条目 (见 rebuildSpatialGrid)
+    static const int GRID_SORT_MIN_LOAD = 2;
+
+    // --- 分时寻路 ---
+    // 单位只提交请求，每个逻辑帧在预算内推进，避免大批单位同时改道时卡帧
+    PathScheduler m_pathScheduler;
+
+    // --- 休眠调度 ---
+    // 周围没有敌人的单位和塔不再每帧索敌，敌人进入监视块或超时才唤醒
+    ActivityScheduler m_activity;
+
+    // --- 战场事件 ---
+    // 塔被摧毁 / 单位生成 / 单位死亡，由 Game 在逻辑线程发布
+    EventBus m_eventBus;
+    // 每队的塔 + 以塔为战略目标的单位 (订阅了总线事件)
+    TowerRegistry m_towerRegistry;
+    // 单位句柄 (同样挂在总线上维护)，子弹等比目标活得久的引用用它
+    UnitHandleTable m_unitHandles;
+
+    // --- 延迟伤害 ---
+    // 攻击和子弹命中只提交伤害，每帧末尾统一结算，结果与单位更新顺序无关
+    DamageBuffer m_damage;
 
     // 1. 单位列表
     std::vector<Unit*> m_units; 
 
-    // 子弹对象池 (管理内存)
-    ObjectPool<Projectile> m_projectilePool;
+    // --- 堆分配统计 ---
+    // 每个逻辑帧在逻辑线程上的堆分配次数 (见 HeapStats)，帧内临时容器走 FrameArena，稳定后应为 0
+    // 每 HEAP_REPORT_TICKS 帧在控制台汇总一次 (只统计逻辑线程，渲染线程的分配不计入)
+    static const int HEAP_REPORT_TICKS = 600;
+    std::uint64_t m_heapTickAllocs;   // 上一帧
+    std::uint64_t m_heapWindowAllocs; // 本统计窗口累计
+    std::uint64_t m_heapWindowMax;    // 本统计窗口单帧最多
+    std::size_t m_arenaWindowPeak;    // 本统计窗口 FrameArena 的峰值用量
+    int m_heapWindowTicks;
+    void recordHeapStats(std::uint64_t tickAllocs);
 
-    // 2. 子弹列表 (仅管理当前活跃的指针)
-    std::vector<Projectile*> m_projectiles;
+    // 2. 子弹 (SoA，按字段存成平行数组，批量更新、一次绘制)
+    ProjectileSystem m_projectiles;
 
     // 3. 废墟列表 (存储已被摧毁的塔的废墟图)
     std::vector<sf::Sprite> m_ruins;
@@ -95,6 +150,15 @@ private:
     // 4. 背景精灵
     sf::Sprite m_bgSprite;
 
+    // 摄像机 (地图区域的可滚动/缩放视图)
+    Camera m_camera;
+    sf::Clock m_frameClock;       // 渲染帧计时 (摄像机平移用)
+    bool m_isDragging;            // 是否正在用右键/中键拖拽地图
+    sf::Vector2i m_lastMousePos;  // 上一次拖拽的鼠标位置
+
+    // 远景替身：所有单位合并成一个顶点数组，一次 draw call
+    sf::VertexArray m_impostors;
+
     // 5. UI 文本
     sf::Text m_gameOverText;
     bool m_gameOver; // 游戏是否结束
@@ -108,6 +172,8 @@ private:
     sf::RectangleShape m_elixirBarFg; // 圣水槽前景 (紫色)
     sf::Sprite m_elixirIcon;          // 圣水滴图标
     sf::Text m_elixirStatusText;      // 显示 "4/10" 的文字
+    int m_elixirShown;                // 文字当前显示的圣水数 (变了才重设字符串)
+    sf::RectangleShape m_cardMask;    // 圣水不够时盖在卡牌上的遮罩 (复用，每帧只改位置大小)
 
     // 难度选择 UI
     sf::Text m_difficultyText;
@@ -126,6 +192,7 @@ private:
     float m_enemyElixirRate; // 敌方回费速度 (受难度影响)
     float m_aiThinkTimer;    // AI 思考计时器
     float m_aiReactionTime;  // AI 思考间隔 (受难度影响)
+    bool m_aiEnabled;
     Difficulty m_difficulty;
     
     // 多线程相关 
@@ -138,6 +205,7 @@ private:
 
     // 初始化功能
     void initWindow();
+    void loadAssets(); // 并行加载资源并显示启动进度条
     void initMap();
     void initUnits(); // 初始化测试单位
     void initTowers();
@@ -151,13 +219,21 @@ private:
     // AI 核心逻辑
     void updateAI(float dt); 
 
+    // 重建空间网格 (每个逻辑帧末尾调用，渲染和下一帧寻敌都用它)
+    void rebuildSpatialGrid();
+
+    // 塔被摧毁：留下废墟，国王塔倒下时结束游戏 (订阅 TOWER_DESTROYED)
+    void onTowerDestroyed(Tower* tower);
+    // 把单位登记到它所在的网格
+    void addToSpatialGrid(Unit* unit);
+
     void render();
+    // 在摄像机视图下绘制地图、单位和子弹 (只画可见部分)
+    // frameDt 用于推进可见单位的动画
+    void renderWorld(float frameDt);
     // 专门负责绘制 UI
     void renderUI();
 
     // 处理鼠标点击逻辑
     void handleMouseClick(int x, int y);
-    
-    // 生成单位的辅助函数
-    void spawnUnit(UnitType type, float x, float y, int team);
 };
\ No newline at end of file
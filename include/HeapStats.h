@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+
+// 堆分配计数
+// HeapStats.cpp 替换了全局 operator new / delete，每次分配累加一次计数：
+//   全进程总数 (原子变量) + 当前线程的计数 (thread_local，读写不需要同步)
+// new[] / nothrow 版本按标准默认转调 operator new(size)，一并计入
+// 逻辑帧前后各读一次当前线程的计数，差值就是这一帧在逻辑线程上的分配次数 (不含渲染线程)
+// 另外记录全进程仍在使用的堆字节数 (按分配器实际给出的块大小) 和它的峰值
+namespace HeapStats {
+
+// 程序启动以来全部线程的分配次数
+std::uint64_t totalAllocations();
+
+// 当前线程的分配次数 / 字节数
+std::uint64_t threadAllocations();
+std::uint64_t threadBytes();
+
+// 全进程当前占用的堆字节数 / 峰值 (对齐版本的 new 不经过这里，不计入)
+std::uint64_t liveBytes();
+std::uint64_t peakLiveBytes();
+
+// 把峰值拉回当前值，用来分段测量 (例如压测时每个规模单独统计峰值)
+void resetPeak();
+
+} // namespace HeapStats
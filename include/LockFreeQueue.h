@@ -0,0 +1,78 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// 有界无锁队列 (多生产者/多消费者)
+// 每个槽位带一个序号，生产者和消费者只用 CAS 推进各自的游标，不加锁
+// Capacity 必须是 2 的幂
+template <typename T, std::size_t Capacity>
+class LockFreeQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    LockFreeQueue() : m_head(0), m_tail(0) {
+        for (std::size_t i = 0; i < Capacity; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // 禁止拷贝
+    LockFreeQueue(const LockFreeQueue&) = delete;
+    LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+    // 入队，队列满时返回 false (调用方决定丢弃还是重试)
+    bool push(const T& value) {
+        std::size_t pos = m_tail.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = m_cells[pos & (Capacity - 1)];
+            std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                // 槽位空闲，尝试占用
+                if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // 满了
+            } else {
+                pos = m_tail.load(std::memory_order_relaxed); // 被别的生产者抢先，重读
+            }
+        }
+    }
+
+    // 出队，队列空时返回 false
+    bool pop(T& out) {
+        std::size_t pos = m_head.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = m_cells[pos & (Capacity - 1)];
+            std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    out = cell.value;
+                    // 序号推进一整圈，表示该槽位可以再次写入
+                    cell.sequence.store(pos + Capacity, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // 空
+            } else {
+                pos = m_head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    // 头尾游标放在不同缓存行，避免生产者和消费者互相抢缓存行
+    std::array<Cell, Capacity> m_cells;
+    alignas(64) std::atomic<std::size_t> m_head;
+    alignas(64) std::atomic<std::size_t> m_tail;
+};
@@ -0,0 +1,109 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "TileMap.h"
+
+// 地图文件
+// 两种格式，内容完全一样：
+//
+// 1. 文本格式 (.map)：方便手写和 diff
+//      # 注释
+//      size <行> <列>
+//      tiles
+//      ....#~~~~=~~~#....     每行一个字符一格：
+//      ...                     . 平地  ~ 河流  = 桥  # 山脉  a 甲方基地  b 乙方基地  , 泥地
+//      end
+//      tower  <A|B> <king|princess> <行> <列>
+//      deploy <A|B> <起始行> <起始列> <结束行> <结束列>   (闭区间矩形，可以有多个)
+//      lane   <A|B> <入口行> <入口列> <目标行> <目标列>   (从入口出发，攻打目标格)
+//
+// 2. 二进制格式 (.bmap)：由 map_compiler 从文本编译，运行时 mmap 后直接拷贝地形
+//      [MapFileHeader][地形 rows*cols 字节][MapTower x N][MapZone x N][MapLane x N]
+//      各段 8 字节对齐，偏移记录在文件头里
+//
+// 队伍字段的数值与 Team 枚举一致 (0 = TEAM_A 上方, 1 = TEAM_B 下方)
+
+const char MAP_MAGIC[4] = { 'B', 'M', 'A', 'P' };
+const std::uint32_t MAP_VERSION = 1;
+
+// 塔的摆放位置
+struct MapTower {
+    std::int32_t row;
+    std::int32_t col;
+    std::uint8_t team;
+    std::uint8_t king;  // 1 = 国王塔, 0 = 公主塔
+    std::uint8_t reserved[2];
+};
+
+// 部署区 (玩家/AI 只能在己方区域放兵)
+struct MapZone {
+    std::int32_t row0, col0; // 左上 (含)
+    std::int32_t row1, col1; // 右下 (含)
+    std::uint8_t team;
+    std::uint8_t reserved[3];
+
+    bool contains(int r, int c) const { return r >= row0 && r <= row1 && c >= col0 && c <= col1; }
+};
+
+// 进攻路线：AI 从入口出兵，单位的战略目标是路线终点 (通常是敌方公主塔)
+struct MapLane {
+    std::int32_t entryRow, entryCol;
+    std::int32_t targetRow, targetCol;
+    std::uint8_t team;
+    std::uint8_t reserved[3];
+};
+
+struct MapFileHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t rows;
+    std::uint32_t cols;
+    std::uint32_t towerCount;
+    std::uint32_t zoneCount;
+    std::uint32_t laneCount;
+    std::uint32_t reserved;
+    std::uint64_t tilesOffset;
+    std::uint64_t towersOffset;
+    std::uint64_t zonesOffset;
+    std::uint64_t lanesOffset;
+};
+
+// 一张完整的地图：地形 + 塔 + 部署区 + 进攻路线
+struct MapData {
+    TileMap tiles;
+    std::vector<MapTower> towers;
+    std::vector<MapZone> deployZones;
+    std::vector<MapLane> lanes;
+
+    // 该格是否在该队伍的部署区内
+    bool inDeployZone(int team, int r, int c) const;
+    // 该队伍能否在这一格部署 (在部署区内且可通行)
+    bool canDeploy(int team, int r, int c) const { return tiles.isPassable(r, c) && inDeployZone(team, r, c); }
+};
+
+class MapFile {
+public:
+    // 按文件头自动识别文本/二进制
+    static bool load(const std::string& fileName, MapData& out);
+
+    // 文本格式：逐行解析
+    static bool loadText(const std::string& fileName, MapData& out);
+    static bool saveText(const std::string& fileName, const MapData& map);
+
+    // 二进制格式：整体 mmap，校验后一次性拷贝地形 (1000x1000 的图就是一次 1MB 的 memcpy)
+    static bool loadBinary(const std::string& fileName, MapData& out);
+    static bool saveBinary(const std::string& fileName, const MapData& map);
+
+    // 程序化生成任意尺寸的对称战场：中线河流 + 两座桥，双方各三座塔
+    // obstacleDensity > 0 时随机撒山脉 (用于寻路/人群压力测试)
+    static bool generate(int rows, int cols, MapData& out, float obstacleDensity = 0.f, unsigned seed = 1);
+
+    // 地形字符 <-> TileType
+    static char tileToChar(TileType type);
+    static bool charToTile(char ch, TileType& type);
+
+private:
+    // 载入后统一校验：塔、部署区、路线都必须落在地图内
+    static bool validate(const MapData& map, const std::string& fileName);
+};
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 只读内存映射文件 (Windows: CreateFileMapping，其他平台: mmap)
+// 映射期间返回的指针一直有效，析构时自动解除映射
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    // 禁止拷贝 (映射句柄只能有一个所有者)
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // 打开并映射整个文件，失败返回 false
+    bool open(const std::string& fileName);
+    void close();
+
+    bool isOpen() const { return m_data != nullptr; }
+    const std::uint8_t* data() const { return m_data; }
+    std::size_t size() const { return m_size; }
+
+private:
+    const std::uint8_t* m_data;
+    std::size_t m_size;
+
+#ifdef _WIN32
+    void* m_fileHandle;
+    void* m_mappingHandle;
+#endif
+};
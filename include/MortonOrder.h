@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+
+// Z 序 (Morton 序)
+// 把格子坐标 (行, 列) 的二进制位交错拼成一个整数：按它排序后，
+// 地图上相邻的格子在序列里大多也相邻 (一个个 2x2、4x4…… 的小方块依次排开)。
+// 空间网格按它排列条目，邻居查询扫的那一片格子在内存里也聚在一起
+namespace MortonOrder {
+
+// 低 16 位每位之间插一个 0：abcd -> 0a0b0c0d
+inline std::uint32_t spreadBits(std::uint32_t v) {
+    v &= 0x0000FFFF;
+    v = (v | (v << 8)) & 0x00FF00FF;
+    v = (v | (v << 4)) & 0x0F0F0F0F;
+    v = (v | (v << 2)) & 0x33333333;
+    v = (v | (v << 1)) & 0x55555555;
+    return v;
+}
+
+// 行列都要小于 65536。行、列任一个变大，key 都变大
+inline std::uint32_t key(int row, int col) {
+    return (spreadBits(static_cast<std::uint32_t>(row)) << 1) | spreadBits(static_cast<std::uint32_t>(col));
+}
+
+} // namespace MortonOrder
@@ -13,36 +13,58 @@ enum class AnimState {
 struct AnimInfo {
     int frameWidth;       // 单帧宽
     int frameHeight;      // 单帧高
-    
+
     int walkFrames;       // 行走状态的总帧数
     int attackFrames;     // 攻击状态的总帧数
-    
+
     float walkDuration;   // 行走单帧时间
     float attackDuration; // 攻击单帧时间
 };
 
+// 逻辑方向数 (5方向 + 水平镜像 = 8方向)
+// 索引 0=Up, 1=UpRight, 2=Right, 3=DownRight, 4=Down
+const int ANIM_DIRECTIONS = 5;
+
+// 预计算的帧矩形表 (每个兵种一份，所有同类单位共享)
+// 运行时只需查表，不再每帧计算裁剪矩形
+struct AnimTable {
+    AnimInfo info;
+    // frames[状态][方向] = 该行所有帧的裁剪矩形
+    std::array<std::array<std::vector<sf::IntRect>, ANIM_DIRECTIONS>, 2> frames;
+
+    // 参数对应 Spritesheet 中的行号 (0-9)，顺序: Up, UpRight, Right, DownRight, Down
+    static AnimTable build(const AnimInfo& info,
+                           const std::array<int, ANIM_DIRECTIONS>& walkRows,
+                           const std::array<int, ANIM_DIRECTIONS>& attackRows);
+
+    const std::vector<sf::IntRect>& get(AnimState state, int dir) const {
+        return frames[state == AnimState::WALK ? 0 : 1][dir];
+    }
+};
+
 class Movable {
 public:
     Movable();
     virtual ~Movable();
 
-    // 初始化精灵和基础参数
-    void initSprite(const sf::Texture& texture, const AnimInfo& info);
-
-    // 设置行与方向的映射关系
-    // 参数对应 Spritesheet 中的行号 (0-9)
-    // 这里的 Up, UpRight 等指代的是逻辑方向，填入对应的行号即可
-    void setWalkRows(int up, int upRight, int right, int downRight, int down);
-    void setAttackRows(int up, int upRight, int right, int downRight, int down);
+    // 初始化精灵，绑定该兵种的帧表 (表的生命周期必须长于单位，一般是函数内 static)
+    void initSprite(const sf::Texture& texture, const AnimTable& table);
 
-    // 设置缩放
+    // 设置缩放 (正值，翻转由动画系统处理)
     void setScale(float scaleX, float scaleY);
 
-    // 核心更新：需要传入当前状态和朝向向量
-    void updateAnimation(float dt, sf::Vector2f dir, AnimState state);
+    // 逻辑线程调用：只记录当前状态和朝向，开销极小
+    void setAnimState(AnimState state, sf::Vector2f dir);
+
+    // 渲染线程调用：推进动画帧，只在帧/方向真正变化时才写精灵
+    void updateAnimation(float dt);
+
+    // 无三角函数的八方向分类 (符号 + 斜率比较)
+    // 返回 0..4 的逻辑方向，flipped 表示是否需要水平镜像
+    static int classifyDirection(sf::Vector2f dir, bool& flipped);
 
     virtual void render(sf::RenderWindow& window);
-    
+
     void setPosition(float x, float y);
     void setPosition(const sf::Vector2f& pos);
     sf::Vector2f getPosition() const;
@@ -51,15 +73,20 @@ public:
 
 protected:
     sf::Sprite m_sprite;
-    AnimInfo m_animInfo;
-   
+    const AnimTable* m_animTable; // 兵种共享的帧表 (塔没有动画，为空)
+    sf::Vector2f m_baseScale;     // 未翻转时的缩放，避免每帧取绝对值
+
+    // 逻辑线程写入的动画输入
+    AnimState m_animState;
+    int m_directionIndex; // 当前逻辑方向 (0..4)
+    bool m_isFlipped;     // 是否水平翻转
+
     float m_animationTimer;// 动画计时器
     int m_currentFrame;// 当前动画帧索引
-      
-    int m_currentRow;// 当前渲染的行号
-    bool m_isFlipped;// 是否水平翻转
-
-    // 映射表: 索引 0=Up, 1=UpRight, 2=Right, 3=DownRight, 4=Down
-    std::array<int, 5> m_walkRowMap;
-    std::array<int, 5> m_attackRowMap;
-};
\ No newline at end of file
+
+    // 上一次真正写入精灵的状态，用于跳过重复的 setTextureRect/setScale
+    AnimState m_appliedState;
+    int m_appliedDirection;
+    int m_appliedFrame;
+    bool m_appliedFlip;
+};
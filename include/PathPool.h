@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <SFML/System.hpp>
+
+// 共享路径池：长路径溢出的路径点存在这里
+// 按固定大小的块分配，块之间用下标串成单链表，释放的块进空闲链表反复使用
+// 只在逻辑线程使用 (单位的寻路和移动都在逻辑线程)，不加锁
+class PathPool {
+public:
+    static const int CHUNK_SIZE = 16; // 每块 16 个路径点 (128 字节)
+
+    struct Chunk {
+        sf::Vector2f points[CHUNK_SIZE];
+        std::int32_t next; // 下一块的下标，-1 表示没有
+    };
+
+    // 获取全局唯一的实例
+    static PathPool& getInstance();
+
+    // 禁止拷贝
+    PathPool(const PathPool&) = delete;
+    void operator=(const PathPool&) = delete;
+
+    // 分配一块 (next 置为 -1)
+    std::int32_t allocate();
+    // 归还一块
+    void release(std::int32_t index);
+
+    Chunk& chunk(std::int32_t index) { return m_chunks[index]; }
+
+    // 统计：总块数 / 正在使用的块数
+    std::size_t capacity() const { return m_chunks.size(); }
+    std::size_t inUse() const { return m_inUse; }
+
+private:
+    PathPool() : m_freeHead(-1), m_inUse(0) {}
+
+    std::vector<Chunk> m_chunks;
+    std::int32_t m_freeHead;
+    std::size_t m_inUse;
+};
+
+// 单位的路径点队列
+// 前 INLINE_CAPACITY 个点放在单位自己身上的环形缓冲里 (平滑后的路径通常只有几个拐点，
+// 根本用不到池)；放不下的按顺序溢出到 PathPool。每弹出一个点，就从溢出段补一个回环里
+// 接口和原来的 std::deque 用法一致：clear / empty / front / pop_front / push_back
+class WaypointQueue {
+public:
+    static const int INLINE_CAPACITY = 8;
+
+    WaypointQueue() = default;
+    ~WaypointQueue() { clear(); }
+
+    // 溢出块归单个队列所有，禁止拷贝
+    WaypointQueue(const WaypointQueue&) = delete;
+    WaypointQueue& operator=(const WaypointQueue&) = delete;
+
+    bool empty() const { return m_count == 0; }
+    std::size_t size() const { return m_count + m_spillCount; }
+
+    const sf::Vector2f& front() const { return m_ring[m_head]; }
+
+    void push_back(const sf::Vector2f& point);
+    void pop_front();
+    void clear();
+
+private:
+    // 环形缓冲
+    sf::Vector2f m_ring[INLINE_CAPACITY];
+    std::uint8_t m_head = 0;
+    std::uint8_t m_count = 0;
+
+    // 溢出段：从 m_spillHead 块的 m_spillRead 位置读，写到 m_spillTail 块的 m_spillWrite 位置
+    std::int32_t m_spillHead = -1;
+    std::int32_t m_spillTail = -1;
+    std::uint8_t m_spillRead = 0;
+    std::uint8_t m_spillWrite = 0;
+    std::uint32_t m_spillCount = 0;
+};
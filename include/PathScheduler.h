@@ -0,0 +1,98 @@
+#pragma once
+#include <cstdint>
+#include <memory_resource>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+#include <SFML/System.hpp>
+#include "Pathfinder.h"
+
+class Unit; // 前向声明
+
+// 寻路请求的紧急程度 (越靠后越先处理)
+enum class PathUrgency : std::uint8_t {
+    REPLAN,    // 手上还有路可走，只是想换一条更新的
+    STRATEGIC, // 推塔单位没有路了
+    COMBAT     // 追击敌人，没有路了
+};
+
+// 分时寻路调度器
+// 一座塔倒下时，所有以它为目标的单位会在同一帧改道去国王塔，原来每个单位当场跑一次完整寻路，
+// 这一帧就会卡一下。现在单位只提交请求，调度器每帧在预算内 (毫秒数 / 展开节点数) 推进搜索：
+//   - 同一时刻只有一个搜索在跑，没搜完就挂起，下一帧接着搜
+//   - 待处理请求按紧急程度排队，同级先到先得
+//   - 每个单位最多一个未完成请求，新请求就地更新旧请求：保留原来的序号 (排队位置不变)，
+//     正在搜的目标只挪了一两格时不打断。追击的单位每 0.5 秒重发一次请求，
+//     如果每次都排到队尾、作废搜了一半的结果，积压时它永远轮不到
+// 搜完后平滑路径，回调 Unit::onPathReady。只在逻辑线程使用
+class PathScheduler {
+public:
+    struct Budget {
+        float maxMillis = 1.0f;      // 每帧最多花多少毫秒
+        int maxExpansions = 50000;   // 每帧最多展开多少节点
+    };
+
+    void setBudget(const Budget& budget) { m_budget = budget; }
+    const Budget& budget() const { return m_budget; }
+
+    // 提交 (或更新) 单位的寻路请求，坐标为格子坐标
+    // 已有请求时沿用它的排队位置，紧急程度只升不降
+    void request(Unit* unit, sf::Vector2i start, sf::Vector2i goal, PathUrgency urgency);
+
+    // 撤销单位的请求 (单位被删除前必须调用)
+    void cancel(Unit* unit);
+
+    // 每个逻辑帧调用一次，在预算内推进搜索并投递结果
+    void update(const TileMap& map);
+
+    // 统计
+    std::size_t pendingCount() const { return m_pending.size(); }
+    int lastExpansions() const { return m_lastExpansions; }
+    float lastMillis() const { return m_lastMillis; }
+
+private:
+    struct Request {
+        sf::Vector2i start;
+        sf::Vector2i goal;
+        std::uint32_t serial; // 请求序号 (第一次提交时分配，更新请求不换)，用来识别失效的队列项
+        PathUrgency urgency;  // 已入队的最高紧急程度
+    };
+
+    // 正在搜的请求，目标挪动不超过这么多格 (切比雪夫距离) 时不重搜，送回的路径终点差这一点无妨
+    static const int GOAL_SLACK_CELLS = 2;
+
+    struct QueueEntry {
+        PathUrgency urgency;
+        std::uint32_t serial;
+        Unit* unit;
+
+        // 大顶堆：紧急程度高的在前，同级序号小 (先提交) 的在前
+        bool operator<(const QueueEntry& other) const {
+            if (urgency != other.urgency) return urgency < other.urgency;
+            return serial > other.serial;
+        }
+    };
+
+    // 取下一个有效请求开始搜索，没有请求时返回 false
+    // 同一个请求可能有多个队列项 (升级紧急程度、重搜)，先出队的那个开始搜，其余的在请求完成后失效
+    bool startNext(const TileMap& map);
+    // 当前搜索结束 (找到或失败)，把结果交给单位
+    void finishActive(const TileMap& map);
+
+    Budget m_budget;
+    // 请求表的节点来回增删 (提交、投递、覆盖)：节点从池里取，归还后留给下一个请求，稳定后不再向堆要内存
+    // 池要比表先构造、后析构
+    std::pmr::unsynchronized_pool_resource m_pendingNodes;
+    std::pmr::unordered_map<Unit*, Request> m_pending{ &m_pendingNodes };
+    std::priority_queue<QueueEntry> m_queue;
+
+    PathSearch m_search;
+    Unit* m_activeUnit = nullptr;
+    std::uint32_t m_activeSerial = 0;
+    std::uint32_t m_nextSerial = 0;
+
+    std::vector<sf::Vector2i> m_result; // 复用的结果缓冲
+
+    int m_lastExpansions = 0;
+    float m_lastMillis = 0.f;
+};
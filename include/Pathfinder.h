@@ -1,18 +1,95 @@
 #pragma once
+#include <cstdint>
 #include <vector>
 #include <SFML/System.hpp>
-#include "Game.h" // 为了获取 TileType 枚举
+#include "TileMap.h" // 地形与可通行位图
+#include "SearchBuffers.h"
+
+// 全图距离场：每格到最近目标格的最小代价 (4 邻接，进入一格的代价见 TileMap::stepCost)
+// 代价均匀时就是步数
+// 用于流场寻路和 AI 局势评估；反复重建时复用内部缓冲，不再分配
+struct DistanceField {
+    static constexpr std::uint32_t UNREACHABLE = 0xFFFFFFFFu;
+
+    int rows = 0;
+    int cols = 0;
+    std::vector<std::uint32_t> dist; // rows * cols，行优先
+
+    std::uint32_t at(int r, int c) const { return dist[r * cols + c]; }
+
+    // 流场查询：从 from 出发，走向距离更小的相邻格；已在目标或不可达时返回 false
+    bool nextStep(sf::Vector2i from, sf::Vector2i& to) const;
+
+    // 位并行 BFS 的波前/已访问位图 (与 TileMap 的带哨兵位图同布局)
+    std::vector<std::uint64_t> frontier;
+    std::vector<std::uint64_t> next;
+    std::vector<std::uint64_t> visited;
+};
+
+// 寻路算法选择 (按次查询指定)
+enum class PathMode {
+    ASTAR, // 4 邻接加权 A*，返回途经的每一格
+    JPS    // 8 邻接跳点搜索 (Jump Point Search)，只返回拐点；桥、泥地等加权格附近按实际代价逐格展开
+};
+
+// 可分段执行的加权 A* (4 邻接，结果与 PathMode::ASTAR 相同)
+// begin() 之后每次 step() 最多展开 maxExpansions 个节点，没搜完就保留开放列表，下次接着搜
+// 每个实例有自己的缓冲，搜索期间地图必须保持存活
+class PathSearch {
+public:
+    enum class Status { IDLE, RUNNING, FOUND, FAILED };
+
+    void begin(const TileMap& map, sf::Vector2i start, sf::Vector2i end);
+    Status step(int maxExpansions);
+
+    Status status() const { return m_status; }
+    // 搜索结果 (不含起点，含终点)，仅在 FOUND 时有效
+    const std::vector<sf::Vector2i>& path() const { return m_path; }
+    // 本次搜索累计展开的节点数
+    int expansions() const { return m_expansions; }
+
+private:
+    const TileMap* m_map = nullptr;
+    sf::Vector2i m_start;
+    sf::Vector2i m_end;
+    SearchScratch m_scratch;
+    BucketQueue m_open;
+    std::vector<sf::Vector2i> m_path;
+    Status m_status = Status::IDLE;
+    int m_expansions = 0;
+};
 
 class Pathfinder {
 public:
-    // 核心函数：输入地图、起点、终点，返回路径点列表
+    // 核心函数：输入地图、起点、终点，返回路径点列表 (不含起点，含终点)
     static std::vector<sf::Vector2i> findPath(
-        const std::vector<std::vector<int>>& mapData, 
+        const TileMap& map, 
         sf::Vector2i start, 
-        sf::Vector2i end
+        sf::Vector2i end,
+        PathMode mode = PathMode::ASTAR
+    );
+
+    // 路径平滑 (拉绳法 / string pulling)：path 是 findPath 的结果 (不含起点)
+    // 从当前锚点出发，能直线看到的最远路径点之前的点全部删掉，只留下拐角
+    // 直线不能穿过障碍、不能切角，也不能穿过比两端更贵的地形 (否则会把绕开的泥地又拉回来)
+    static void smoothPath(const TileMap& map, sf::Vector2i start, std::vector<sf::Vector2i>& path);
+
+    // 两格中心之间的连线是否畅通 (连线经过的每一格都可通行，代价不超过 maxCost)
+    static bool lineOfSight(const TileMap& map, sf::Vector2i from, sf::Vector2i to, int maxCost);
+
+    // 位并行 BFS：一次处理一整个 64 格的字
+    // 每一轮把波前位图向上下左右各移一格，与可通行位图求与、去掉已访问的，就是下一圈
+    // 一轮的代价是 O(行数 x 每行字数)，而不是 O(格子数)
+    // 加权格 (桥、泥地、拥堵) 被波前碰到时距离已经确定 (= 这一圈 + 代价 - 1)，
+    // 先放进桶队列，等到那一圈再并入波前，所以结果和 Dijkstra 相同，加权格少时几乎不增加开销
+    static void buildDistanceField(
+        const TileMap& map,
+        const std::vector<sf::Vector2i>& goals,
+        DistanceField& field
     );
 
 private:
-    // 辅助结构：检查坐标是否越界或不可通行
-    static bool isValid(const std::vector<std::vector<int>>& mapData, int r, int c);
+    // 跳点搜索 (起点终点已校验)
+    // 斜向移动不允许切角：两侧的直邻格都可通行才能斜走
+    static std::vector<sf::Vector2i> findPathJPS(const TileMap& map, sf::Vector2i start, sf::Vector2i end);
 };
\ No newline at end of file
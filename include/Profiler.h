@@ -0,0 +1,108 @@
+#pragma once
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// 分段计时 (逻辑帧的各个阶段、寻路、渲染)
+// 每段计时结束时往当前线程的环形缓冲里写一条 { 名字, 开始时间, 时长 }：
+//   - 每个线程一个缓冲，写入不加锁，只有一次原子的下标递增
+//   - 缓冲写满后覆盖最旧的记录，所以里面永远是最近的 RING_CAPACITY 条
+// 需要时再从所有缓冲汇总：
+//   - writeChromeTrace  导出 Chrome trace_event JSON (chrome://tracing 或 Perfetto 打开)
+//   - printSummary      按名字统计最近一段时间的次数 / p50 / p99 / 最大值
+//   - summarize         同样的统计，返回给调用方 (压测报告用)
+//
+// 计时点用下面的宏插入，编译时没有定义 BATTLESIM_PROFILE 时宏展开为空，一条指令都不留
+// 名字必须是字符串字面量 (只存指针)
+namespace Profiler {
+
+static const std::size_t RING_CAPACITY = 1 << 16; // 每个线程保留的记录数 (2 的幂)
+
+// 单调时钟，纳秒
+std::uint64_t nowNs();
+
+// 记录一段 [startNs, endNs)
+void record(const char* name, std::uint64_t startNs, std::uint64_t endNs);
+
+// 给当前线程起名 (显示在 trace 里)，name 必须是字符串字面量
+void setThreadName(const char* name);
+
+// 导出所有线程缓冲里的记录，失败返回 false
+bool writeChromeTrace(const std::string& path);
+
+// 一个名字的统计 (毫秒)
+struct PhaseStats {
+    std::string name;
+    std::size_t calls;
+    double p50, p99, max, total;
+};
+
+// 按名字汇总开始时间不早于 sinceNs 的记录，按总耗时从大到小排列
+// 缓冲写满后最旧的记录已被覆盖，统计只覆盖还留在缓冲里的那部分
+std::vector<PhaseStats> summarize(std::uint64_t sinceNs);
+
+// 按名字汇总最近的记录，按总耗时从大到小输出
+void printSummary(std::ostream& out);
+
+// 作用域计时：构造时开始，析构时记录
+class ScopedTimer {
+public:
+    explicit ScopedTimer(const char* name) : m_name(name), m_start(nowNs()) {}
+    ~ScopedTimer() { record(m_name, m_start, nowNs()); }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    const char* m_name;
+    std::uint64_t m_start;
+};
+
+// 顺序阶段计时：next() 结束上一段、开始下一段，析构时结束最后一段
+// 用在一个长函数里按步骤切分，不用给每一步套一层花括号
+class PhaseTimer {
+public:
+    PhaseTimer() = default;
+    ~PhaseTimer() { close(); }
+
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+    void next(const char* name) {
+        std::uint64_t now = nowNs();
+        if (m_name) record(m_name, m_start, now);
+        m_name = name;
+        m_start = now;
+    }
+
+    void close() {
+        if (m_name) record(m_name, m_start, nowNs());
+        m_name = nullptr;
+    }
+
+private:
+    const char* m_name = nullptr;
+    std::uint64_t m_start = 0;
+};
+
+} // namespace Profiler
+
+#define BATTLESIM_PROFILE_CONCAT_(a, b) a##b
+#define BATTLESIM_PROFILE_CONCAT(a, b) BATTLESIM_PROFILE_CONCAT_(a, b)
+
+#ifdef BATTLESIM_PROFILE
+// 从这里到作用域结束计一段
+#define PROFILE_SCOPE(name) ::Profiler::ScopedTimer BATTLESIM_PROFILE_CONCAT(profileScope_, __LINE__)(name)
+// 在函数开头声明一次，之后每个 PROFILE_PHASE 结束上一段、开始新的一段
+#define PROFILE_PHASES() ::Profiler::PhaseTimer profilePhases_
+#define PROFILE_PHASE(name) profilePhases_.next(name)
+#define PROFILE_PHASES_END() profilePhases_.close()
+#define PROFILE_THREAD(name) ::Profiler::setThreadName(name)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_PHASES() ((void)0)
+#define PROFILE_PHASE(name) ((void)0)
+#define PROFILE_PHASES_END() ((void)0)
+#define PROFILE_THREAD(name) ((void)0)
+#endif
@@ -0,0 +1,101 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <vector>
+#include "AssetManifest.h"
+#include "UnitHandle.h"
+
+class Unit; // 前向声明
+class DamageBuffer;
+
+// 子弹种类 (每个远程兵种一种)
+enum class ProjectileKind : std::uint8_t {
+    BULLET, // 塔的炮弹：追踪
+    ARROW,  // 弓箭手：按提前量直线飞
+    DART,   // 吹箭：更快更小，直线飞
+    COUNT
+};
+
+// 每种子弹的外观和弹道参数
+struct ProjectileStyle {
+    TextureId texture;
+    int left, top, width, height; // 贴图区域，width 为 0 表示整张图
+    float scale;
+    bool rotates;    // 按飞行方向旋转 (贴图朝 +x)
+    bool homing;     // true = 每帧转向目标；false = 发射时算好提前量后直线飞
+    float speed;     // 像素/秒
+    float hitRadius; // 命中判定半径 (像素)
+};
+
+// 箭取自 arrow_sheet 第一组 (朝右) 里的一支
+inline constexpr ProjectileStyle PROJECTILE_STYLES[] = {
+    /* BULLET */ { TextureId::BULLET,      0, 0,  0, 0, 1.0f,  false, true,  300.f, 10.f },
+    /* ARROW  */ { TextureId::ARROW_SHEET, 0, 0, 76, 9, 0.5f,  true,  false, 600.f, 12.f },
+    /* DART   */ { TextureId::ARROW_SHEET, 0, 0, 76, 9, 0.3f,  true,  false, 900.f, 10.f },
+};
+static_assert(sizeof(PROJECTILE_STYLES) / sizeof(PROJECTILE_STYLES[0]) == static_cast<std::size_t>(ProjectileKind::COUNT),
+              "每种子弹都要有一行样式");
+
+// 子弹系统 (SoA)
+// 所有子弹的数据按字段存成平行数组：
+//   位置 / 速度 / 飞行速率 / 目标句柄 / 伤害 / 剩余寿命 / 存活标记
+// 每帧 update 先把目标位置收集到数组里，再一次性批量完成转向、扫掠命中判定和积分 (SSE 一次 4 颗)，
+// 最后提交命中的伤害、压缩掉失效的子弹。
+// 命中判定用本帧的移动线段和目标圆求交，而不是只看端点：
+// 吹箭一帧能飞十几像素，比命中半径还大，只看端点会直接穿过去
+// 子弹本身没有精灵，渲染时每种贴图拼一个顶点数组，一次 draw call
+// 目标用句柄而不是 Unit*：目标在子弹飞行途中被删除也不会访问悬空指针
+class ProjectileSystem {
+public:
+    // 命中只向 damage 提交伤害，由它在帧末统一结算
+    ProjectileSystem(const UnitHandleTable& units, DamageBuffer& damage);
+
+    // 从 pos 向 target 发射一颗子弹 (逻辑线程)
+    // 直线飞的种类在这里按目标当前速度解出拦截点
+    void spawn(sf::Vector2f pos, const Unit* target, float damage, ProjectileKind kind = ProjectileKind::BULLET);
+
+    // 推进所有子弹并结算命中 (逻辑线程)
+    void update(float dt);
+
+    // 绘制 visible 范围内的子弹 (渲染线程，调用方持有游戏锁)
+    void render(sf::RenderTarget& target, const sf::FloatRect& visible);
+
+    std::size_t size() const { return m_x.size(); }
+    void clear();
+
+    // 预留容量：数组只增不减，峰值之后再多的子弹也不会分配
+    static const std::size_t INITIAL_CAPACITY = 4096;
+
+    // 提前量：速率为 speed 的子弹从 from 出发，拦截以 targetVel 匀速运动、当前在 targetPos 的目标
+    // 返回飞行时间 (追不上返回 -1)
+    static float interceptTime(sf::Vector2f from, sf::Vector2f targetPos, sf::Vector2f targetVel, float speed);
+
+private:
+    // 批量转向 + 扫掠命中 + 积分，命中的写进 m_hit
+    void integrate(float dt);
+    // 把存活的子弹压缩到数组前部 (保持发射顺序)
+    void compact();
+    void reserve(std::size_t capacity);
+
+    const UnitHandleTable& m_units;
+    DamageBuffer& m_damageBuffer;
+
+    // --- 每颗子弹一个元素 ---
+    std::vector<float> m_x, m_y;         // 位置
+    std::vector<float> m_vx, m_vy;       // 速度 (像素/秒)
+    std::vector<float> m_speed;          // 飞行速率
+    std::vector<float> m_homing;         // 1 = 追踪，0 = 直线 (用作混合系数，方便批量计算)
+    std::vector<float> m_radius2;        // 命中半径的平方
+    std::vector<float> m_life;           // 剩余寿命 (秒)，直线飞的错过目标后到点消失
+    std::vector<float> m_damage;
+    std::vector<UnitHandle> m_target;
+    std::vector<ProjectileKind> m_kind;
+    std::vector<std::uint8_t> m_alive;
+
+    // --- 每帧临时数据 (容量复用) ---
+    std::vector<float> m_tx, m_ty;       // 本帧目标位置
+    std::vector<std::uint8_t> m_hit;     // 本帧是否命中
+
+    // 渲染批次，每种子弹一个 (只在渲染线程使用)
+    sf::VertexArray m_batches[static_cast<std::size_t>(ProjectileKind::COUNT)];
+};
@@ -1,8 +1,16 @@
 #pragma once
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
-#include <map>
+#include <array>
 #include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include "ThreadPool.h"
+#include "AssetArchive.h"
+#include "AssetManifest.h"
 
 // 单例模式资源管理器
 class ResourceManager {
@@ -14,31 +22,83 @@ public:
     ResourceManager(const ResourceManager&) = delete;
     void operator=(const ResourceManager&) = delete;
 
-    // --- 纹理 (图片) 管理 ---
-    // name: 给资源起的别名 (例如 "knight_sheet")
-    // fileName: 文件路径 (例如 "assets/textures/knight_spritesheet.png")
-    void loadTexture(const std::string& name, const std::string& fileName);
-    // 获取纹理引用，用于 Sprite 设置
-    sf::Texture& getTexture(const std::string& name);
+    // --- 资源获取 ---
+    // 句柄是 AssetManifest.h 里生成的编译期常量，查找就是一次数组下标
+    // (构造单位、子弹时会频繁调用，不做字符串比较和哈希)
+    sf::Texture& getTexture(TextureId id) { return m_textures[static_cast<std::size_t>(id)]; }
+    sf::Font& getFont(FontId id) { return m_fonts[static_cast<std::size_t>(id)]; }
 
-    // --- 音效 管理 ---
-    void loadSoundBuffer(const std::string& name, const std::string& fileName);
-    sf::SoundBuffer& getSoundBuffer(const std::string& name);
+    sf::SoundBuffer& getSoundBuffer(SoundId id) {
+        std::size_t index = static_cast<std::size_t>(id);
+        // 音频在后台延迟加载：还没解码完就等它一下 (通常开局几百毫秒内就都好了)
+        if (!m_soundReady[index].load(std::memory_order_acquire)) {
+            waitForSound(index);
+        }
+        return m_soundBuffers[index];
+    }
 
-    // 字体管理
-    void loadFont(const std::string& name, const std::string& fileName);
-    sf::Font& getFont(const std::string& name);
+    // --- 打包资源 ---
+    // 映射离线打包好的 assets.pak (由 asset_packer 生成)
+    // 挂载成功后，包里有的资源直接从映射内存创建，不做任何解码和逐文件 IO
+    bool mountArchive(const std::string& fileName);
 
+    // --- 异步加载 ---
+    // 按资源清单 (AssetManifest.h) 把读文件和解码任务提交到线程池，立即返回
+    // 图片/音频/字体在后台线程并行解码，只有纹理上传留在主线程
+    void startAsyncLoad();
+
+    // 主线程每帧调用：把已经解码好的图片上传为纹理
+    // 返回 true 表示第一帧需要的资源 (纹理、字体) 都已就绪
+    // 音频不算在内，它们会在游戏开始后继续在后台加载
+    bool pumpUploads();
+
+    // 关键资源的加载进度 (0..1)，用于启动进度条
+    float getLoadProgress() const;
 
     // --- 统一加载 ---
-    // 一次性加载项目中所有已知的资源
+    // 一次性加载项目中所有已知的资源 (同步等待全部完成，包括音频)
     void loadAllAssets();
 
 private:
-    ResourceManager() = default; // 私有构造函数
+    ResourceManager(); // 私有构造函数
+    ~ResourceManager();
+
+    // 后台线程解码完成、等待主线程上传的图片
+    struct DecodedImage {
+        std::size_t index;
+        std::string fileName;
+        sf::Image image;
+        bool ok;
+        bool critical;
+    };
+
+    // 生成加载失败时的品红色占位纹理
+    static void makePlaceholder(sf::Texture& tex);
+
+    // 从已挂载的包中直接创建资源 (主线程调用)，包里没有该条目时返回 false
+    bool loadFromArchive(const AssetEntry& entry);
+
+    // 阻塞等待某个音频解码完成 (冷路径)
+    void waitForSound(std::size_t index);
+
+    // 资源管理器数据：按句柄下标存放的定长数组
+    std::array<sf::Texture, TEXTURE_COUNT> m_textures;
+    std::array<sf::SoundBuffer, SOUND_COUNT> m_soundBuffers;
+    std::array<sf::Font, FONT_COUNT> m_fonts;
+
+    // 打包资源 (映射在整个程序生命周期内有效，字体直接引用这块内存)
+    AssetArchive m_archive;
+
+    // --- 异步加载状态 ---
+    // 每个后台任务只写自己下标的元素，互不干扰
+    std::unique_ptr<ThreadPool> m_loaderPool;
+    bool m_asyncStarted;
+
+    mutable std::mutex m_loadMutex;
+    std::condition_variable m_soundReadyCv;
+    std::vector<DecodedImage> m_decodedImages;   // 等待上传的图片 (受 m_loadMutex 保护)
+    std::array<std::atomic<bool>, SOUND_COUNT> m_soundReady; // 音频是否解码完成
 
-    // 资源管理器数据
-    std::map<std::string, sf::Texture> m_textures;
-    std::map<std::string, sf::SoundBuffer> m_soundBuffers;
-    std::map<std::string, sf::Font> m_fonts;
+    std::atomic<int> m_criticalTotal; // 关键资源总数
+    std::atomic<int> m_criticalDone;  // 已就绪的关键资源数
 };
\ No newline at end of file
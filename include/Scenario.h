@@ -0,0 +1,44 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "Game.h"
+
+// 压力测试场景：按兵种配比和数量给两队铺满单位
+// 地图可以是任意尺寸 (文件载入或程序化生成)，单位只放在各自的部署区里
+//
+// 配比写法: "knight:3,archers:1" (名字见 unitName，权重按比例分数量)，空 = 六个兵种平均
+enum class ScenarioLayout {
+    RANDOM,    // 部署区内随机撒
+    FORMATION  // 从己方前沿 (靠近敌方的一侧) 往后排成方阵：肉盾在前、远程在后
+};
+
+// 配比中的一项
+struct ScenarioSquad {
+    UnitType type;
+    int weight;
+};
+
+struct ScenarioSpec {
+    int unitsPerTeam[2] = { 0, 0 };     // 下标即 Team
+    std::vector<ScenarioSquad> mix[2];  // 空 = 六个兵种平均
+    ScenarioLayout layout = ScenarioLayout::FORMATION;
+    unsigned seed = 1;
+};
+
+class Scenario {
+public:
+    // 解析配比，失败时打印原因并返回 false
+    static bool parseMix(const std::string& text, std::vector<ScenarioSquad>& out);
+    // "random" / "formation"
+    static bool parseLayout(const std::string& text, ScenarioLayout& out);
+
+    static const char* unitName(UnitType type);
+
+    // 给 totalUnits 个单位程序化生成地图时的边长：平均每 4 格一个单位，不小于默认地图
+    static void fitMapSize(int totalUnits, int& rows, int& cols);
+
+    // 按场景在 game 里生成单位 (在 run() 之前或无窗口模式下调用)，返回生成的数量
+    // 部署区放不下时同一格叠放多个，格内错开一点位置
+    static std::size_t populate(Game& game, const ScenarioSpec& spec);
+};
@@ -0,0 +1,77 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "TileMap.h"
+
+// 寻路用的可复用缓冲：一次同步查询 (Pathfinder) 和分段执行的查询 (PathSearch) 共用
+
+// 搜索用的每格状态，按地图大小分配一次后反复使用
+// 用 "代数" 标记代替每次清空：stamp != 当前代数 的格子视为未访问
+struct SearchScratch {
+    std::vector<std::uint32_t> stamp;
+    std::vector<std::int32_t> g;
+    std::vector<std::int32_t> parent;
+    std::vector<std::uint8_t> closed;
+    std::uint32_t generation = 0;
+
+    void prepare(std::size_t cells) {
+        if (stamp.size() != cells) {
+            stamp.assign(cells, 0);
+            g.resize(cells);
+            parent.resize(cells);
+            closed.resize(cells);
+            generation = 0;
+        }
+        if (++generation == 0) { // 回绕：真正清空一次
+            std::fill(stamp.begin(), stamp.end(), 0);
+            generation = 1;
+        }
+    }
+};
+
+// 桶队列 (Dial 算法)
+// 键是小整数，出队的键单调不减，且新入队的键不超过当前键 + BUCKETS - 1 时，
+// 用一圈循环桶代替二叉堆：push 是一次 push_back，pop 只需向前找第一个非空桶
+// A* 里 f' = f + 代价 + (h' - h) <= f + MAX_STEP_COST + 1，Dijkstra 里增量 <= MAX_STEP_COST
+class BucketQueue {
+public:
+    static const int BUCKETS = 32; // 2 的幂，取模用位与
+    static_assert(BUCKETS > TileMap::MAX_STEP_COST + 1, "bucket ring too small for step costs");
+
+    void clear() {
+        for (auto& bucket : m_buckets) bucket.clear(); // 只清内容，保留容量
+        m_size = 0;
+    }
+
+    bool empty() const { return m_size == 0; }
+
+    void push(std::uint32_t key, std::int32_t value) {
+        // 队列空时 m_current 停在上次弹出的键，新键可能比它小 (但不会小于上次弹出的键)
+        if (m_size == 0 || key < m_current) m_current = key;
+        m_buckets[key & (BUCKETS - 1)].push_back(value);
+        m_size++;
+    }
+
+    // 最小的键 (调用方保证队列非空)
+    std::uint32_t minKey() {
+        while (m_buckets[m_current & (BUCKETS - 1)].empty()) m_current++;
+        return m_current;
+    }
+
+    // 弹出键最小的一项，key 返回它的键
+    std::int32_t pop(std::uint32_t& key) {
+        while (m_buckets[m_current & (BUCKETS - 1)].empty()) m_current++;
+        std::vector<std::int32_t>& bucket = m_buckets[m_current & (BUCKETS - 1)];
+        std::int32_t value = bucket.back();
+        bucket.pop_back();
+        m_size--;
+        key = m_current;
+        return value;
+    }
+
+private:
+    std::vector<std::int32_t> m_buckets[BUCKETS];
+    std::size_t m_size = 0;
+    std::uint32_t m_current = 0;
+};
@@ -0,0 +1,113 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+class Unit; // 前向声明
+
+// 空间划分网格：一格对应地图上的一个 tile
+// 原来的 vector<vector<Unit*>> 每个格子一个独立分配，4096x4096 的地图光空 vector 就要几百 MB
+// 这里改成 "格子头 + 链表"：
+//   m_heads[格子]  -> 该格第一个条目的下标 (-1 表示空)
+//   m_entries[i]   -> { 单位, 位置/阵营快照, 同格下一个条目 }
+// 每格只占 4 字节，插入 O(1)；清空时只重置本轮用过的格子，不扫整张地图
+//
+// 条目里顺带存了单位的位置、阵营和是否建筑：邻居查询按这些过滤，只有最后选中的单位才去读单位对象本身。
+// 单位对象按生成顺序散落在堆上，逐个解引用就是逐个缓存未命中
+// 整批插入后可以调用 sortByCell()，把条目按格子的 Z 序重新排成连续的一段段，
+// 同一格、相邻格的条目在内存里也挨着 (单位扎堆、每格条目多时才划算)
+class SpatialGrid {
+public:
+    struct Entry {
+        Unit* unit;
+        float x, y;          // 插入时的位置快照 (网格在帧末重建，一帧之内最多差一步移动)
+        std::int32_t next;
+        std::uint8_t team;
+        bool structure;
+    };
+
+    // 遍历一个格子内的条目：for (const SpatialGrid::Entry& e : grid.cell(r, c))
+    class CellRange {
+    public:
+        class Iterator {
+        public:
+            Iterator(const Entry* entries, std::int32_t index) : m_entries(entries), m_index(index) {}
+            const Entry& operator*() const { return m_entries[m_index]; }
+            Iterator& operator++() { m_index = m_entries[m_index].next; return *this; }
+            bool operator!=(const Iterator& other) const { return m_index != other.m_index; }
+        private:
+            const Entry* m_entries;
+            std::int32_t m_index;
+        };
+
+        CellRange(const Entry* entries, std::int32_t head) : m_entries(entries), m_head(head) {}
+        Iterator begin() const { return Iterator(m_entries, m_head); }
+        Iterator end() const { return Iterator(m_entries, -1); }
+        bool empty() const { return m_head < 0; }
+
+    private:
+        const Entry* m_entries;
+        std::int32_t m_head;
+    };
+
+    SpatialGrid();
+
+    // 按地图尺寸分配格子 (地图变化时调用)
+    void resize(int rows, int cols);
+
+    // 清空所有单位 (只重置占用过的格子)
+    void clear();
+
+    // 按坐标插入，越界的单位直接忽略
+    void insert(Unit* unit, int r, int c);
+
+    // 把条目按格子重排：有单位的格子按 Z 序排开，每格的条目连成一段，格内顺序不变
+    // 只改内存布局，cell() 遍历到的内容和顺序都和排序前一样。之后仍然可以继续 insert
+    void sortByCell();
+
+    int rows() const { return m_rows; }
+    int cols() const { return m_cols; }
+
+    // 本轮的条目数 / 有单位的格子数
+    std::size_t entryCount() const { return m_entries.size(); }
+    std::size_t occupiedCells() const { return m_touched.size(); }
+
+    bool inBounds(int r, int c) const {
+        return static_cast<unsigned>(r) < static_cast<unsigned>(m_rows) &&
+               static_cast<unsigned>(c) < static_cast<unsigned>(m_cols);
+    }
+
+    // 调用方保证坐标在界内
+    CellRange cell(int r, int c) const { return CellRange(m_entries.data(), m_heads[r * m_cols + c]); }
+
+    // --- 监视块 (给 ActivityScheduler 用) ---
+    // 地图按 WATCH_BLOCK x WATCH_BLOCK 格分块，每块记录每队有几个休眠者在盯着
+    // insert 时单位落进被敌队盯着的块，就记一条警报 (块下标 * 2 + 盯着的队伍)，每块每队每轮只记一次
+    static const int WATCH_BLOCK = 8;
+
+    int blockRows() const { return m_blockRows; }
+    int blockCols() const { return m_blockCols; }
+
+    // 给 [r0, r1] x [c0, c1] 块范围内的监视计数加 delta (块坐标，调用方保证在界内)
+    void addWatch(int team, int r0, int c0, int r1, int c1, int delta);
+
+    const std::vector<std::int32_t>& alarms() const { return m_alarms; }
+    void clearAlarms();
+
+private:
+    int m_rows;
+    int m_cols;
+    std::vector<std::int32_t> m_heads;
+    std::vector<Entry> m_entries;
+    std::vector<std::int32_t> m_touched; // 本轮有单位的格子，clear() 时只重置这些
+    // sortByCell 的临时数组 (复用容量)
+    std::vector<std::uint64_t> m_cellKeys;
+    std::vector<std::uint64_t> m_keyScratch;
+    std::vector<Entry> m_sorted;
+
+    int m_blockRows;
+    int m_blockCols;
+    // 块数 x 2 队。10 万单位的密度下一块 (8x8 格) 能被几万个休眠者同时盯着，16 位计数会悄悄回绕丢报警
+    std::vector<std::uint32_t> m_watch;
+    std::vector<std::uint8_t> m_alarmed;  // 同布局，本轮已记过警报
+    std::vector<std::int32_t> m_alarms;
+};
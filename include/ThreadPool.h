@@ -0,0 +1,87 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <algorithm>
+
+// 简单的固定大小线程池
+// 任务按提交顺序 (FIFO) 执行，先提交的优先
+class ThreadPool {
+public:
+    // threadCount = 0 表示按 CPU 核数自动决定
+    explicit ThreadPool(unsigned threadCount = 0) : m_stopping(false), m_busy(0) {
+        if (threadCount == 0) {
+            threadCount = std::max(2u, std::thread::hardware_concurrency());
+        }
+        for (unsigned i = 0; i < threadCount; ++i) {
+            m_workers.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    // 禁止拷贝
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // 析构时先把队列里的任务做完，再回收线程
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_taskReady.notify_all();
+        for (auto& t : m_workers) {
+            if (t.joinable()) t.join();
+        }
+    }
+
+    // 提交一个任务
+    void submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tasks.push_back(std::move(task));
+        }
+        m_taskReady.notify_one();
+    }
+
+    // 阻塞直到所有已提交的任务完成
+    void waitIdle() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idle.wait(lock, [this] { return m_tasks.empty() && m_busy == 0; });
+    }
+
+    unsigned size() const { return static_cast<unsigned>(m_workers.size()); }
+
+private:
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_taskReady;
+    std::condition_variable m_idle;
+    bool m_stopping;
+    unsigned m_busy; // 正在执行的任务数
+
+    void workerLoop() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_taskReady.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+                if (m_tasks.empty()) return; // stopping 且没有剩余任务
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+                ++m_busy;
+            }
+
+            task();
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                --m_busy;
+                if (m_tasks.empty() && m_busy == 0) m_idle.notify_all();
+            }
+        }
+    }
+};
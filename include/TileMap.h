@@ -0,0 +1,138 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// 地形类型枚举 (一格只占 1 字节)
+enum TileType : std::uint8_t {
+    GROUND = 0, // 平地 (草绿)
+    RIVER,      // 河流 (蓝色)
+    BRIDGE,     // 桥梁 (木色)
+    MOUNTAIN,   // 山脉 (灰色)
+    BASE_A,     // 甲方基地 (红色)
+    BASE_B,     // 乙方基地 (蓝色)
+    MUD         // 泥地 (可走，但慢)
+};
+const int TILE_TYPE_COUNT = 7;
+
+// 地形元数据 (按 TileType 下标)
+struct TileInfo {
+    bool passable;
+    std::uint8_t cost;   // 寻路时进入该格的代价 (平地 = 1，小整数，桶队列依赖这一点)
+    float speedFactor;   // 单位走在该地形上的速度倍率 (不可通行地形填 1，防止贴边的单位卡死)
+};
+
+inline constexpr TileInfo TILE_INFO[TILE_TYPE_COUNT] = {
+    { true,  1, 1.0f }, // GROUND
+    { false, 0, 1.0f }, // RIVER
+    { true,  2, 1.0f }, // BRIDGE   桥面窄，大家都挤一座桥时不如绕到另一座
+    { false, 0, 1.0f }, // MOUNTAIN
+    { true,  1, 1.0f }, // BASE_A
+    { true,  1, 1.0f }, // BASE_B
+    { true,  3, 0.5f }, // MUD      走得慢，能绕就绕
+};
+
+// 运行时大小的地图
+// - 地形：一维 uint8_t 数组，索引 = row * cols + col，按行顺序扫描就是顺序访存
+// - 可通行：由地形派生的位图，每格 1 bit，寻路只查这个 (一条缓存行覆盖 512 格)
+//   位图四周各多一圈恒为 0 的哨兵格：第 r 行第 c 列存在位图的 (r + 1, c + 1)
+//   所以界内格子的上下左右邻居 (哪怕在地图外) 都可以直接查，不需要越界判断
+//   每行单独按 64 位字对齐，整行可以按字做位运算 (见 Pathfinder::buildDistanceField)
+// - 加权格：同样布局的位图，代价大于 1 (桥、泥地、拥堵) 的格子置 1
+//   跳点搜索和位并行 BFS 靠它把少量加权格单独处理，其余格子照样整段跳过 / 整字推进
+// 修改地形必须走 set()，保证位图同步
+class TileMap {
+public:
+    // 地图边长上限 (4096 x 4096 = 16M 格，地形 16MB，位图约 2MB)
+    static const int MAX_DIM = 4096;
+    // 单格代价上限 (地形代价 + 拥堵惩罚)，寻路的桶队列按它分配桶数
+    static const int MAX_STEP_COST = 15;
+
+    TileMap();
+
+    // 重新分配为 rows x cols，全部填成 fill；尺寸非法返回 false
+    bool create(int rows, int cols, TileType fill = GROUND);
+
+    // 从现成的地形字节 (rows * cols，行优先) 整体载入，并重新生成可通行位图
+    // 含有非法地形值时返回 false
+    bool assign(int rows, int cols, const std::uint8_t* tiles);
+
+    int rows() const { return m_rows; }
+    int cols() const { return m_cols; }
+    int size() const { return m_rows * m_cols; }
+
+    bool inBounds(int r, int c) const {
+        // 转成无符号，一次比较同时排除负数
+        return static_cast<unsigned>(r) < static_cast<unsigned>(m_rows) &&
+               static_cast<unsigned>(c) < static_cast<unsigned>(m_cols);
+    }
+
+    // 调用方保证坐标在界内
+    TileType at(int r, int c) const { return static_cast<TileType>(m_tiles[r * m_cols + c]); }
+    void set(int r, int c, TileType type);
+
+    // 越界视为不可通行
+    bool isPassable(int r, int c) const {
+        if (!inBounds(r, c)) return false;
+        return isPassableUnchecked(r, c);
+    }
+
+    // 不做越界判断：r 取 [-1, rows]，c 取 [-1, cols] 都安全 (落在哨兵上返回 false)
+    // 用于展开界内格子的邻居
+    bool isPassableUnchecked(int r, int c) const {
+        unsigned bit = static_cast<unsigned>(c + 1);
+        return (m_passable[(r + 1) * m_wordsPerRow + (bit >> 6)] >> (bit & 63)) & 1u;
+    }
+
+    // --- 按字访问位图 (位并行算法用) ---
+    // 每行的字数 (含左右哨兵列)
+    int wordsPerRow() const { return m_wordsPerRow; }
+    // 第 r 行 (r 取 [-1, rows]) 的起始字；第 c 列是该行第 c + 1 位
+    const std::uint64_t* passableRow(int r) const { return m_passable.data() + (r + 1) * m_wordsPerRow; }
+    // 加权格位图的第 r 行 (布局同上)
+    const std::uint64_t* weightedRow(int r) const { return m_weighted.data() + (r + 1) * m_wordsPerRow; }
+
+    // (r, c) 或它周围 8 格里有加权格吗？(r、c 取值范围同 isPassableUnchecked)
+    bool hasWeightedAround(int r, int c) const {
+        // 第 c - 1 .. c + 1 列存在第 c .. c + 2 位，可能跨两个字
+        unsigned bit = static_cast<unsigned>(c);
+        unsigned word = bit >> 6, shift = bit & 63;
+        for (int dr = -1; dr <= 1; ++dr) {
+            const std::uint64_t* row = weightedRow(r + dr);
+            std::uint64_t bits = row[word] >> shift;
+            if (shift > 61) bits |= row[word + 1] << (64 - shift);
+            if (bits & 7u) return true;
+        }
+        return false;
+    }
+
+    // 该地形能不能走：河流和山脉不可走，地面/桥/基地/泥地可走
+    static bool isPassableType(TileType type) { return TILE_INFO[type].passable; }
+
+    // --- 通行代价 ---
+    // 进入该格的代价 (调用方保证坐标在界内且可通行)
+    int stepCost(int r, int c) const { return m_costs[r * m_cols + c]; }
+
+    // 动态拥堵惩罚：在地形代价上额外加 penalty (0 表示清除)，总代价不超过 MAX_STEP_COST
+    void setCongestion(int r, int c, int penalty);
+
+    // 所有可通行格的代价都是 1 吗？(有桥、泥地或拥堵惩罚的地图返回 false)
+    // 是的话跳点搜索和位并行 BFS 可以连加权格的检查都省掉
+    bool isUniformCost() const { return m_weightedCells == 0; }
+
+    // 原始地形数据 (rows * cols 字节，行优先)
+    const std::uint8_t* data() const { return m_tiles.data(); }
+
+private:
+    int m_rows;
+    int m_cols;
+    std::vector<std::uint8_t> m_tiles;
+    int m_wordsPerRow;
+    std::vector<std::uint8_t> m_costs;     // 每格通行代价 (不可通行为 0)
+    int m_weightedCells;                   // 代价大于 1 的格子数
+    std::vector<std::uint64_t> m_passable; // 带哨兵边框的可通行位图，(rows + 2) 行 x m_wordsPerRow 字
+    std::vector<std::uint64_t> m_weighted; // 加权格位图，同布局
+
+    static void setBit(std::vector<std::uint64_t>& bits, int wordsPerRow, int r, int c, bool value);
+    void setPassableBit(int r, int c, bool passable) { setBit(m_passable, m_wordsPerRow, r, c, passable); }
+    void setCost(int index, int cost);
+};
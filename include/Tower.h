@@ -14,17 +14,23 @@ public:
 
     // 重写 update：塔不移动，但会发射子弹
     virtual void update(float dt, 
-                        const std::vector<std::vector<Unit*>>& spatialGrid, 
-                        std::vector<Projectile*>& activeProjectiles, 
-                        ObjectPool<Projectile>& projectilePool, 
-                        const std::vector<std::vector<int>>& mapData) override;
+                        const SpatialGrid& spatialGrid, 
+                        ProjectileSystem& projectiles, 
+                        DamageBuffer& damage,
+                        const TileMap& map,
+                        PathScheduler& pathScheduler) override;
 
     // 判断是否为国王塔
     bool isKing() const { return m_type == TowerType::KING; }
 
+    virtual bool isStructure() const override { return true; }
+
+    // 塔不会移动，可以一直睡到有敌人进入监视范围，超时只是兜底
+    virtual float maxSleepTime() const override { return 2.0f; }
+
 private:
     TowerType m_type;
     
     // 塔的攻击逻辑
-    void shoot(Unit* target, std::vector<Projectile*>& activeProjectiles, ObjectPool<Projectile>& projectilePool);
+    void shoot(Unit* target, ProjectileSystem& projectiles);
 };
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+#include <vector>
+#include "EventBus.h"
+
+class Unit;  // 前向声明
+class Tower;
+
+// 按队伍登记场上的塔，并维护 "谁把这座塔当作战略目标" 的订阅表
+// 原来每个推塔单位每帧都去目标格子里 dynamic_cast 找塔、再用写死的坐标算国王塔位置；
+// 现在单位只在生成时订阅一次，塔被摧毁时由这里通知订阅者改道去敌方国王塔
+// 所有信息都来自事件总线：
+//   UNIT_SPAWNED    塔 -> 登记；单位 -> 订阅它战略目标格上的敌方塔
+//   TOWER_DESTROYED 通知订阅者改道，然后注销
+//   UNIT_DIED       取消该单位的订阅
+class TowerRegistry {
+public:
+    // 订阅总线上的事件 (在放置任何塔和单位之前调用)
+    void attach(EventBus& bus);
+
+    // 该队伍的国王塔 (已被摧毁时返回 nullptr)，队伍数值与 Team 枚举一致
+    Tower* king(int team) const;
+
+    // 该队伍还剩几座塔
+    int towerCount(int team) const { return static_cast<int>(m_entries[team].size()); }
+
+private:
+    struct Entry {
+        Tower* tower;
+        std::vector<Unit*> subscribers;
+    };
+
+    void onSpawned(Unit* unit);
+    void onTowerDestroyed(Tower* tower);
+    void onUnitDied(Unit* unit);
+
+    Entry* find(Tower* tower);
+    // 该格上的活塔 (不存在返回 nullptr)
+    Tower* towerAt(int team, int row, int col) const;
+    // 让单位以 tower 为战略目标 (tower 为空时原地待命)
+    void assign(Unit* unit, Tower* tower);
+    void unsubscribe(Unit* unit);
+
+    std::vector<Entry> m_entries[2]; // 每队最多几座塔，线性查找就够了
+};
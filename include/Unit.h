@@ -1,13 +1,16 @@
 #pragma once
 #include <SFML/Graphics.hpp>
-#include <SFML/Audio.hpp>
 #include <vector>
-#include <deque> // 使用双端队列存储路径
 #include "Game.h" // 需要知道 TILE_SIZE
 #include "Movable.h"
-#include "ObjectPool.h"
+#include "UnitHandle.h" // 单位句柄
+#include "ProjectileSystem.h" // 子弹种类
+#include "AssetManifest.h" // 资源句柄
+#include "PathPool.h" // 路径点队列
+#include "PathScheduler.h" // 分时寻路
 
-class Projectile; // 前向声明
+class Tower; // 前向声明
+class DamageBuffer;
 
 // 阵营枚举
 enum Team {
@@ -24,35 +27,86 @@ public:
     // 核心函数
     // dt = delta time (上一帧到这一帧经过的时间，秒)
     // allUnits: 场上所有单位列表 (用于寻敌)
-    // projectiles: 子弹列表 (用于发射子弹)
-    // mapData: 地图数据 (用于寻路)
+    // projectiles: 子弹系统 (用于发射子弹)
+    // damage: 伤害只提交到这里，逻辑帧末尾统一结算
+    // map: 地图数据 (用于寻路)
+    // pathScheduler: 寻路请求提交到这里，结果在之后的某一帧通过 onPathReady 送回
     virtual void update(float dt,
-                        const std::vector<std::vector<Unit*>>& spatialGrid, 
-                        std::vector<Projectile*>& activeProjectiles, 
-                        ObjectPool<Projectile>& projectilePool,
-                        const std::vector<std::vector<int>>& mapData); 
+                        const SpatialGrid& spatialGrid, 
+                        ProjectileSystem& projectiles,
+                        DamageBuffer& damage,
+                        const TileMap& map,
+                        PathScheduler& pathScheduler); 
 
     virtual void render(sf::RenderWindow& window) override;
 
+    // 绘制头顶 UI (血条、皇冠)，远景 LOD 下会被跳过
+    void renderHud(sf::RenderWindow& window);
+
+    // 是否为建筑 (塔)，渲染时用它区分替身大小，避免 dynamic_cast
+    virtual bool isStructure() const { return false; }
+
     // 设置初始战略目标（直接设置坐标）
     void setStrategicTarget(float x, float y);
+    sf::Vector2f getStrategicTarget() const { return m_strategicTarget; }
+
+    // 战略目标塔：订阅关系由 TowerRegistry 维护，塔被摧毁时它会调用 retarget
+    Tower* getStrategicTower() const { return m_strategicTower; }
+    void setStrategicTower(Tower* tower) { m_strategicTower = tower; }
+    // 改去另一座塔 (目标变了，丢弃当前路径)
+    void retarget(sf::Vector2f target, Tower* tower);
 
-    // 设置移动目标
-    void setTarget(float tx, float ty, const std::vector<std::vector<int>>& mapData);
+    // 设置移动目标 (提交寻路请求)
+    void setTarget(float tx, float ty, PathScheduler& pathScheduler, PathUrgency urgency);
+
+    // 调度器送回寻路结果 (格子坐标，已平滑)
+    void onPathReady(const std::vector<sf::Vector2i>& path, bool found);
+    // 已提交寻路请求，结果还没送回
+    bool isPathPending() const { return m_pathPending; }
     
     // 获取状态
     bool isAlive() const { return m_hp > 0; }
     bool isDead() const { return m_hp <= 0; }
 
     Team getTeam() const { return m_team; }
-
-    // 战斗接口
-    void takeDamage(float damage);
+    float getAggroRange() const { return m_aggroRange; }
+    float getSpeed() const { return m_speed; }
+    // 本帧的实际移动速度 (像素/秒)，远程单位算提前量用
+    sf::Vector2f getVelocity() const { return m_velocity; }
+
+    // --- 休眠 (由 ActivityScheduler 管理) ---
+    // 休眠中的单位不扫描周围找敌人，移动、计时照常
+    bool isAsleep() const { return m_sleepSlot >= 0; }
+    int getSleepSlot() const { return m_sleepSlot; }
+    void setSleepSlot(int slot) { m_sleepSlot = slot; }
+    // 本帧 update 发现周围没有敌人时置位，Game 取走后交给调度器
+    bool takeSleepRequest() { bool wants = m_wantsSleep; m_wantsSleep = false; return wants; }
+    // 最长休眠时间：移动的单位会走出监视范围，不能睡太久
+    virtual float maxSleepTime() const { return 0.5f; }
+
+    // --- 决策频率 ---
+    // 索敌、验证锁定、定时换路这些 "思考" 每 m_thinkInterval 个逻辑帧才做一次，
+    // 移动、攻击计时、动画仍然每帧更新。各单位错开相位，每帧只有一部分单位在思考
+    // 全局倍率是 AI 开销的调节旋钮 (1 = 各兵种默认间隔，越大越省)
+    static void setThinkScale(float scale) { s_thinkScale = scale; }
+    static float getThinkScale() { return s_thinkScale; }
+
+    // 句柄 (由 UnitHandleTable 分配，比单位活得久的引用方持有它)
+    UnitHandle getHandle() const { return m_handle; }
+    void setHandle(UnitHandle handle) { m_handle = handle; }
+
+    // 战斗接口 (由 DamageBuffer 在结算时调用，攻击方不要直接调用)
+    // 单次命中经护甲减免后的伤害
+    float mitigate(float amount) const;
+    // 扣掉本帧汇总的伤害，并触发受击反馈
+    void applyDamage(float total);
 
 protected: 
     Team m_team;
+    UnitHandle m_handle;
     float m_hp;     // 当前血量
     float m_maxHp; // 最大血量
+    float m_armor;  // 护甲：每次命中减免的固定伤害
     float m_atk;    // 攻击力
     float m_speed;   // 像素/秒
     float m_range;   // 攻击距离
@@ -60,8 +114,23 @@ protected:
     
     // 战略目标 (当前要去的塔的坐标)
     sf::Vector2f m_strategicTarget;
+    Tower* m_strategicTower; // 目标塔 (没有目标塔时为空)
     // 当前锁定的敌人 (非塔单位)
-    Unit* m_lockedEnemy; 
+    // 存句柄不存指针：伤害在帧末统一结算，倒下的单位同一帧就被删除，攻击方下一帧再读裸指针就悬空了
+    UnitHandle m_lockedEnemy;
+
+    // 决策间隔 (逻辑帧数，兵种构造函数里设置：慢的肉盾长，快的远程短)
+    int m_thinkInterval;
+    int m_thinkCountdown; // 减到 0 就思考一次
+    static float s_thinkScale;
+    static unsigned s_thinkPhase; // 轮流分配相位
+
+    // 本帧是否轮到思考 (每帧调用一次)
+    bool tickThink();
+
+    // 休眠状态
+    int m_sleepSlot;   // 在 ActivityScheduler 里的下标，-1 表示醒着
+    bool m_wantsSleep; // 本帧没找到敌人，请求休眠
 
     // 攻击冷却
     float m_attackInterval; // 攻击间隔(秒)
@@ -72,13 +141,17 @@ protected:
 
     // 记录朝向，用于静止攻击时的动画方向
     sf::Vector2f m_facingDir; 
+    // 本帧移动速度 (followPath 写入，没走就是 0)
+    sf::Vector2f m_velocity;
 
-    // 寻路相关：存储一系列要走过的世界坐标点
-    std::deque<sf::Vector2f> m_pathQueue; 
+    // 寻路相关：存储一系列要走过的世界坐标点 (平滑后的拐点，长路径溢出到共享路径池)
+    WaypointQueue m_pathQueue;
+    bool m_pathPending;         // 已提交请求，结果还没回来
+    sf::Vector2f m_pathGoal;    // 最近一次请求的目标 (等结果期间直接朝它走)
+    float m_pathRetryTimer;     // 寻路失败后隔一会儿再试
 
-    //  音频组件
-    sf::Sound m_deploySound; // 部署/出生时播放
-    sf::Sound m_hitSound;    // 攻击造成伤害时播放
+    // 音效句柄 (声部由 AudioMixer 统一管理，单位本身不持有 sf::Sound)
+    SoundId m_hitSfx; // 攻击造成伤害时播放
 
     // --- UI 组件 ---
     sf::RectangleShape m_hpBarBg; // 血条背景 (黑/灰)
@@ -93,20 +166,28 @@ protected:
     // 更新 UI 状态 (位置、血量长度)
     void updateUI();
 
-    // 初始化音效
-    void initSounds(const std::string& deployKey, const std::string& hitKey);
+    // 初始化音效 (同时投递部署音效)
+    void initSounds(SoundId deployKey, SoundId hitKey);
     
-    // 沿着路径移动
-    void followPath(float dt);
+    // 沿着路径移动 (速度按脚下地形缩放)
+    // 路径还没算出来时直接朝请求的目标走，前方不可通行就原地等
+    void followPath(float dt, const TileMap& map);
+
+    // 请求通往战略目标的路径
+    void pathfindToStrategic(PathScheduler& pathScheduler);
 
-    // 重新计算通往战略目标的路径
-    void pathfindToStrategic(const std::vector<std::vector<int>>& mapData);
+    // 提交寻路请求 (已经站在目标格上时不提交)
+    void requestPath(PathScheduler& pathScheduler, sf::Vector2f target, PathUrgency urgency);
+
+    // 目标变了：丢弃当前路径和还没回来的结果
+    void resetPath();
 
     // 虚函数，允许子类(如巨人)自定义寻敌逻辑
-    virtual Unit* findClosestEnemy(const std::vector<std::vector<Unit*>>& spatialGrid);
+    virtual Unit* findClosestEnemy(const SpatialGrid& spatialGrid);
 
     // 虚函数，允许子类(如瓦基丽)自定义攻击行为(例如AOE)
-    virtual void performAttack(Unit* target, const std::vector<std::vector<Unit*>>& spatialGrid);
+    // 远程单位不直接扣血，而是向 projectiles 发射子弹
+    virtual void performAttack(Unit* target, const SpatialGrid& spatialGrid, ProjectileSystem& projectiles, DamageBuffer& damage);
 };
 
 
@@ -127,6 +208,12 @@ public:
 class Ranged : public Unit {
 public:
     Ranged(float x, float y, Team team);
+
+protected:
+    // 发射子弹，伤害在命中时才结算
+    virtual void performAttack(Unit* target, const SpatialGrid& spatialGrid, ProjectileSystem& projectiles, DamageBuffer& damage) override;
+
+    ProjectileKind m_projectileKind; // 兵种构造函数里设置
 };
 
 
@@ -137,7 +224,7 @@ class Giant : public Tank {
 public: 
     Giant(float x, float y, Team team);
     // 巨人只打建筑(目前表现为忽略小兵，只往基地走)
-    virtual Unit* findClosestEnemy(const std::vector<std::vector<Unit*>>& spatialGrid) override;
+    virtual Unit* findClosestEnemy(const SpatialGrid& spatialGrid) override;
 };
 
 class Pekka : public Tank {
@@ -155,7 +242,7 @@ class Valkyrie : public Melee {
 public:
     Valkyrie(float x, float y, Team team);
     // 瓦基丽的旋风斩(AOE)
-    virtual void performAttack(Unit* target, const std::vector<std::vector<Unit*>>& spatialGrid) override;
+    virtual void performAttack(Unit* target, const SpatialGrid& spatialGrid, ProjectileSystem& projectiles, DamageBuffer& damage) override;
 };
 
 // 3. Ranged 类
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+class Unit;  // 前向声明
+class EventBus;
+
+// 单位句柄：槽位下标 + 代数
+// 单位被删除后槽位的代数加一，旧句柄再也解析不出来，不会像裸指针那样悬空
+// (子弹之类比目标活得久的东西应该持有句柄而不是 Unit*)
+struct UnitHandle {
+    std::uint32_t index = 0;
+    std::uint32_t generation = 0; // 0 表示空句柄
+
+    bool isNull() const { return generation == 0; }
+};
+
+// 句柄表：单位生成时分配槽位，死亡/摧毁时回收
+// 和 TowerRegistry 一样挂在事件总线上自动维护，只在逻辑线程使用
+class UnitHandleTable {
+public:
+    // 订阅总线上的事件 (在放置任何塔和单位之前调用)
+    void attach(EventBus& bus);
+
+    UnitHandle add(Unit* unit);
+    void remove(UnitHandle handle);
+
+    // 句柄对应的单位，已被删除 (或空句柄) 返回 nullptr
+    Unit* get(UnitHandle handle) const {
+        if (handle.index >= m_slots.size()) return nullptr;
+        const Slot& slot = m_slots[handle.index];
+        return slot.generation == handle.generation ? slot.unit : nullptr;
+    }
+
+    // 当前登记的单位数
+    std::size_t size() const { return m_slots.size() - m_free.size(); }
+
+private:
+    struct Slot {
+        Unit* unit = nullptr;
+        std::uint32_t generation = 1;
+    };
+
+    std::vector<Slot> m_slots;
+    std::vector<std::uint32_t> m_free; // 空闲槽位
+};
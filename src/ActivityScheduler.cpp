@@ -0,0 +1,71 @@
+#include "ActivityScheduler.h"
+#include "Unit.h"
+#include <algorithm>
+
+void ActivityScheduler::sleep(Unit* unit, SpatialGrid& grid) {
+    if (unit->isAsleep() || grid.blockRows() == 0) return;
+
+    // 监视半径 = 警戒范围 + 休眠期间最多能走多远
+    float maxSleep = unit->maxSleepTime();
+    float radius = unit->getAggroRange() + unit->getSpeed() * maxSleep;
+    sf::Vector2f pos = unit->getPosition();
+
+    const float blockSize = static_cast<float>(SpatialGrid::WATCH_BLOCK * Game::TILE_SIZE);
+    Sleeper s;
+    s.unit = unit;
+    s.team = unit->getTeam();
+    s.r0 = std::max(0, static_cast<int>((pos.y - radius) / blockSize));
+    s.c0 = std::max(0, static_cast<int>((pos.x - radius) / blockSize));
+    s.r1 = std::min(grid.blockRows() - 1, static_cast<int>((pos.y + radius) / blockSize));
+    s.c1 = std::min(grid.blockCols() - 1, static_cast<int>((pos.x + radius) / blockSize));
+    s.wakeAt = m_time + maxSleep;
+    if (s.r0 > s.r1 || s.c0 > s.c1) return; // 整个监视范围都在地图外
+
+    grid.addWatch(s.team, s.r0, s.c0, s.r1, s.c1, +1);
+    unit->setSleepSlot(static_cast<int>(m_sleepers.size()));
+    m_sleepers.push_back(s);
+}
+
+void ActivityScheduler::update(float dt, SpatialGrid& grid) {
+    m_time += dt;
+    m_lastWakeCount = 0;
+
+    // 1. 网格警报：敌人进了监视块，唤醒盯着这一块的同队休眠者
+    const int blockCols = grid.blockCols();
+    for (std::int32_t slot : grid.alarms()) {
+        int team = slot & 1;
+        int block = slot >> 1;
+        int br = block / blockCols;
+        int bc = block % blockCols;
+        for (std::size_t i = m_sleepers.size(); i-- > 0;) {
+            const Sleeper& s = m_sleepers[i];
+            if (s.team == team && br >= s.r0 && br <= s.r1 && bc >= s.c0 && bc <= s.c1) {
+                wake(i, grid);
+            }
+        }
+    }
+    grid.clearAlarms();
+
+    // 2. 到期的休眠者
+    for (std::size_t i = m_sleepers.size(); i-- > 0;) {
+        if (m_sleepers[i].wakeAt <= m_time) wake(i, grid);
+    }
+}
+
+void ActivityScheduler::cancel(Unit* unit, SpatialGrid& grid) {
+    if (unit->isAsleep()) wake(static_cast<std::size_t>(unit->getSleepSlot()), grid);
+}
+
+void ActivityScheduler::wake(std::size_t index, SpatialGrid& grid) {
+    Sleeper& s = m_sleepers[index];
+    grid.addWatch(s.team, s.r0, s.c0, s.r1, s.c1, -1);
+    s.unit->setSleepSlot(-1);
+
+    // 交换删除，顺带修正被换过来的休眠者的下标
+    if (index + 1 != m_sleepers.size()) {
+        s = m_sleepers.back();
+        s.unit->setSleepSlot(static_cast<int>(index));
+    }
+    m_sleepers.pop_back();
+    m_lastWakeCount++;
+}
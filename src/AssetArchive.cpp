@@ -0,0 +1,126 @@
+#include "AssetArchive.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+// ======================= 读取 =======================
+
+bool AssetArchive::open(const std::string& fileName) {
+    if (!m_file.open(fileName)) return false;
+
+    const std::uint8_t* base = m_file.data();
+    std::size_t size = m_file.size();
+
+    // 校验文件头，任何一项不对都当作没有包 (回退到散文件)
+    if (size < sizeof(PakHeader)) { m_file.close(); return false; }
+    const PakHeader* header = reinterpret_cast<const PakHeader*>(base);
+    if (std::memcmp(header->magic, PAK_MAGIC, 4) != 0 || header->version != PAK_VERSION) {
+        std::cerr << "[AssetArchive] Bad header in " << fileName << std::endl;
+        m_file.close();
+        return false;
+    }
+    if (header->indexOffset + header->entryCount * sizeof(PakEntry) > size ||
+        header->stringsOffset + header->stringTableSize > size) {
+        std::cerr << "[AssetArchive] Truncated archive: " << fileName << std::endl;
+        m_file.close();
+        return false;
+    }
+
+    m_entries = reinterpret_cast<const PakEntry*>(base + header->indexOffset);
+    m_entryCount = header->entryCount;
+    m_strings = reinterpret_cast<const char*>(base + header->stringsOffset);
+
+    for (std::uint32_t i = 0; i < m_entryCount; ++i) {
+        if (m_entries[i].dataOffset + m_entries[i].dataSize > size) {
+            std::cerr << "[AssetArchive] Entry out of range in " << fileName << std::endl;
+            m_file.close();
+            return false;
+        }
+    }
+    return true;
+}
+
+const PakEntry* AssetArchive::find(const std::string& name) const {
+    // 条目按名字排序，二分查找
+    std::uint32_t lo = 0, hi = m_entryCount;
+    while (lo < hi) {
+        std::uint32_t mid = (lo + hi) / 2;
+        int cmp = entryName(m_entries[mid]).compare(name);
+        if (cmp == 0) return &m_entries[mid];
+        if (cmp < 0) lo = mid + 1;
+        else         hi = mid;
+    }
+    return nullptr;
+}
+
+// ======================= 写入 =======================
+
+void AssetArchiveWriter::add(const std::string& name, AssetKind kind, const void* data, std::uint64_t size,
+                             std::uint32_t param0, std::uint32_t param1, std::uint64_t param2) {
+    Item item;
+    item.name = name;
+    item.entry = PakEntry{};
+    item.entry.kind = static_cast<std::uint32_t>(kind);
+    item.entry.param0 = param0;
+    item.entry.param1 = param1;
+    item.entry.param2 = param2;
+    item.entry.dataSize = size;
+    const std::uint8_t* bytes = static_cast<const std::uint8_t*>(data);
+    item.bytes.assign(bytes, bytes + size);
+    m_items.push_back(std::move(item));
+}
+
+bool AssetArchiveWriter::write(const std::string& fileName) const {
+    // 1. 按名字排序，运行时才能二分
+    std::vector<const Item*> items;
+    for (const auto& item : m_items) items.push_back(&item);
+    std::sort(items.begin(), items.end(), [](const Item* a, const Item* b) { return a->name < b->name; });
+
+    // 2. 字符串表
+    std::string strings;
+    std::vector<PakEntry> entries;
+    for (const Item* item : items) {
+        PakEntry e = item->entry;
+        e.nameOffset = static_cast<std::uint32_t>(strings.size());
+        e.nameLength = static_cast<std::uint32_t>(item->name.size());
+        strings += item->name;
+        entries.push_back(e);
+    }
+
+    // 3. 计算布局：头 -> 索引 -> 字符串 -> 对齐的数据区
+    auto align = [](std::uint64_t v) { return (v + PAK_DATA_ALIGN - 1) & ~(PAK_DATA_ALIGN - 1); };
+
+    PakHeader header;
+    std::memcpy(header.magic, PAK_MAGIC, 4);
+    header.version = PAK_VERSION;
+    header.entryCount = static_cast<std::uint32_t>(entries.size());
+    header.stringTableSize = static_cast<std::uint32_t>(strings.size());
+    header.indexOffset = sizeof(PakHeader);
+    header.stringsOffset = header.indexOffset + entries.size() * sizeof(PakEntry);
+
+    std::uint64_t cursor = align(header.stringsOffset + strings.size());
+    for (auto& e : entries) {
+        e.dataOffset = cursor;
+        cursor = align(cursor + e.dataSize);
+    }
+
+    // 4. 写出
+    std::ofstream out(fileName, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    auto pad = [&out](std::uint64_t target) {
+        static const char zeros[PAK_DATA_ALIGN] = {};
+        std::uint64_t pos = static_cast<std::uint64_t>(out.tellp());
+        if (target > pos) out.write(zeros, static_cast<std::streamsize>(target - pos));
+    };
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(PakEntry)));
+    out.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+    for (std::size_t i = 0; i < items.size(); ++i) {
+        pad(entries[i].dataOffset);
+        out.write(reinterpret_cast<const char*>(items[i]->bytes.data()), static_cast<std::streamsize>(items[i]->bytes.size()));
+    }
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,164 @@
+#include "AudioMixer.h"
+#include "ResourceManager.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+namespace {
+    // 音频线程的混音周期 (约 60Hz，与渲染帧同一量级)
+    const auto MIX_PERIOD = std::chrono::milliseconds(16);
+    // 一帧最多处理的事件数，超出的留到下一帧
+    const int MAX_EVENTS_PER_FRAME = 256;
+    // 距离衰减：超过这个距离就听不见了 (像素)
+    const float HEARING_RADIUS = 1200.f;
+    const float BASE_VOLUME = 70.f;
+    // 低于这个音量的事件直接丢弃，不占声部
+    const float MIN_AUDIBLE_VOLUME = 3.f;
+}
+
+AudioMixer& AudioMixer::getInstance() {
+    static AudioMixer instance;
+    return instance;
+}
+
+AudioMixer::AudioMixer()
+    : m_running(false), m_listenerX(0.f), m_listenerY(0.f)
+{
+    for (auto& voice : m_voices) {
+        voice.priority = SoundPriority::LOW;
+        voice.position = sf::Vector2f(0.f, 0.f);
+    }
+}
+
+AudioMixer::~AudioMixer() {
+    stop();
+}
+
+void AudioMixer::start() {
+    if (m_running.exchange(true)) return;
+    m_thread = std::thread(&AudioMixer::audioLoop, this);
+    std::cout << "[AudioMixer] Started with " << VOICE_COUNT << " voices" << std::endl;
+}
+
+void AudioMixer::stop() {
+    if (!m_running.exchange(false)) return;
+    if (m_thread.joinable()) m_thread.join();
+    for (auto& voice : m_voices) voice.sound.stop();
+}
+
+void AudioMixer::post(SoundId id, sf::Vector2f position, SoundPriority priority) {
+    if (id == SoundId::COUNT) return; // 没有配置音效
+    SoundEvent event{ id, priority, position };
+    // 满了就丢：音效丢一个听不出来，不能让逻辑线程等音频线程
+    m_events.push(event);
+}
+
+void AudioMixer::setListener(sf::Vector2f position) {
+    m_listenerX.store(position.x, std::memory_order_relaxed);
+    m_listenerY.store(position.y, std::memory_order_relaxed);
+}
+
+float AudioMixer::distanceTo(sf::Vector2f a, sf::Vector2f b) const {
+    sf::Vector2f d = a - b;
+    return std::sqrt(d.x * d.x + d.y * d.y);
+}
+
+void AudioMixer::audioLoop() {
+    auto nextFrame = std::chrono::steady_clock::now();
+    while (m_running) {
+        mixFrame();
+        nextFrame += MIX_PERIOD;
+        std::this_thread::sleep_until(nextFrame);
+    }
+}
+
+void AudioMixer::mixFrame() {
+    sf::Vector2f listener(m_listenerX.load(std::memory_order_relaxed),
+                          m_listenerY.load(std::memory_order_relaxed));
+
+    // 1. 取出本帧的事件，相同音效合并成一条
+    // 同一帧里 20 个弓箭手同时命中，只播一次，音量稍微大一点
+    std::array<PendingSound, SOUND_COUNT> merged;
+    std::array<bool, SOUND_COUNT> used{};
+    int drained = 0;
+    SoundEvent event;
+    while (drained < MAX_EVENTS_PER_FRAME && m_events.pop(event)) {
+        drained++;
+        std::size_t index = static_cast<std::size_t>(event.id);
+        float dist = distanceTo(event.position, listener);
+        if (!used[index]) {
+            used[index] = true;
+            merged[index] = { event, 1, dist };
+            continue;
+        }
+        PendingSound& pending = merged[index];
+        pending.count++;
+        // 保留优先级最高、离听者最近的那一个作为代表
+        if (event.priority > pending.event.priority ||
+            (event.priority == pending.event.priority && dist < pending.distance)) {
+            pending.event = event;
+            pending.distance = dist;
+        }
+    }
+    if (drained == 0) return;
+
+    // 2. 按 优先级 → 距离 排序，重要的先分配声部
+    std::array<PendingSound, SOUND_COUNT> ordered;
+    int orderedCount = 0;
+    for (std::size_t i = 0; i < SOUND_COUNT; ++i) {
+        if (used[i]) ordered[orderedCount++] = merged[i];
+    }
+    std::sort(ordered.begin(), ordered.begin() + orderedCount,
+        [](const PendingSound& a, const PendingSound& b) {
+            if (a.event.priority != b.event.priority) return a.event.priority > b.event.priority;
+            return a.distance < b.distance;
+        });
+
+    // 3. 分配声部并播放 (每帧限量)
+    int started = 0;
+    for (int i = 0; i < orderedCount && started < MAX_STARTS_PER_FRAME; ++i) {
+        const PendingSound& pending = ordered[i];
+
+        // 线性距离衰减，合并的次数越多越响 (对数增长，避免爆音)
+        float falloff = std::max(0.f, 1.f - pending.distance / HEARING_RADIUS);
+        float loudness = 1.f + 0.25f * std::log2(static_cast<float>(pending.count));
+        float volume = std::min(100.f, BASE_VOLUME * falloff * loudness);
+        if (volume < MIN_AUDIBLE_VOLUME) continue;
+
+        Voice* voice = acquireVoice(pending, listener);
+        if (!voice) continue; // 全被更重要的声音占着
+
+        voice->sound.stop();
+        voice->sound.setBuffer(ResourceManager::getInstance().getSoundBuffer(pending.event.id));
+        voice->sound.setVolume(volume);
+        voice->sound.play();
+        voice->priority = pending.event.priority;
+        voice->position = pending.event.position;
+        started++;
+    }
+}
+
+AudioMixer::Voice* AudioMixer::acquireVoice(const PendingSound& pending, sf::Vector2f listener) {
+    // 优先用空闲声部
+    Voice* victim = nullptr;
+    float victimDist = 0.f;
+    for (auto& voice : m_voices) {
+        if (voice.sound.getStatus() != sf::Sound::Playing) return &voice;
+
+        // 候选抢占对象：优先级最低，其次离听者最远
+        float dist = distanceTo(voice.position, listener);
+        if (!victim || voice.priority < victim->priority ||
+            (voice.priority == victim->priority && dist > victimDist)) {
+            victim = &voice;
+            victimDist = dist;
+        }
+    }
+
+    // 只抢比自己不重要的：优先级更低，或同优先级但更远
+    if (victim->priority < pending.event.priority ||
+        (victim->priority == pending.event.priority && victimDist > pending.distance)) {
+        return victim;
+    }
+    return nullptr;
+}
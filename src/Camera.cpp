@@ -0,0 +1,96 @@
+#include "Camera.h"
+#include <algorithm>
+
+// LOD 切换阈值 (缩放倍率)
+const float LOD_NO_HUD_ZOOM = 1.75f;
+const float LOD_IMPOSTOR_ZOOM = 3.0f;
+
+// 键盘平移速度 (屏幕像素/秒，与缩放无关)
+const float PAN_SPEED = 600.f;
+
+Camera::Camera()
+    : m_zoom(1.f), m_minZoom(0.5f), m_maxZoom(4.f)
+{
+}
+
+void Camera::init(sf::Vector2f worldSize, sf::Vector2f screenSize, sf::Vector2u windowSize) {
+    m_worldSize = worldSize;
+    m_screenSize = screenSize;
+
+    // 地图区域只占窗口上方，底部留给 UI
+    m_view.setViewport(sf::FloatRect(0.f, 0.f,
+        screenSize.x / windowSize.x, screenSize.y / windowSize.y));
+
+    // 最远能缩到看见整张地图 (至少允许 4 倍，方便在小地图上观察 LOD)
+    float fitZoom = std::max(worldSize.x / screenSize.x, worldSize.y / screenSize.y);
+    m_maxZoom = std::max(4.f, fitZoom * 1.1f);
+
+    reset();
+}
+
+void Camera::reset() {
+    // 默认 1:1，对准地图中心
+    m_zoom = 1.f;
+    m_view.setSize(m_screenSize);
+    m_view.setCenter(m_worldSize.x / 2.f, m_worldSize.y / 2.f);
+    clampCenter();
+}
+
+void Camera::update(float dt) {
+    sf::Vector2f dir(0.f, 0.f);
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::A) || sf::Keyboard::isKeyPressed(sf::Keyboard::Left))  dir.x -= 1.f;
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::D) || sf::Keyboard::isKeyPressed(sf::Keyboard::Right)) dir.x += 1.f;
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::W) || sf::Keyboard::isKeyPressed(sf::Keyboard::Up))    dir.y -= 1.f;
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::S) || sf::Keyboard::isKeyPressed(sf::Keyboard::Down))  dir.y += 1.f;
+
+    if (dir.x != 0.f || dir.y != 0.f) {
+        panPixels(dir * PAN_SPEED * dt);
+    }
+}
+
+void Camera::zoomAt(float factor, sf::Vector2f worldAnchor) {
+    float newZoom = std::clamp(m_zoom * factor, m_minZoom, m_maxZoom);
+    float applied = newZoom / m_zoom;
+    if (applied == 1.f) return;
+
+    // 保持鼠标下的世界坐标不动：中心向锚点方向收缩/扩张
+    sf::Vector2f center = m_view.getCenter();
+    m_view.setCenter(worldAnchor + (center - worldAnchor) * applied);
+    m_view.setSize(m_screenSize * newZoom);
+    m_zoom = newZoom;
+    clampCenter();
+}
+
+void Camera::panPixels(sf::Vector2f pixelDelta) {
+    // 屏幕像素 -> 世界像素
+    m_view.move(pixelDelta * m_zoom);
+    clampCenter();
+}
+
+void Camera::clampCenter() {
+    sf::Vector2f center = m_view.getCenter();
+    sf::Vector2f half = m_view.getSize() / 2.f;
+
+    // 视图比地图小：中心限制在 [half, world - half]
+    // 视图比地图大：固定在地图中心
+    for (int axis = 0; axis < 2; ++axis) {
+        float& c = (axis == 0) ? center.x : center.y;
+        float h = (axis == 0) ? half.x : half.y;
+        float w = (axis == 0) ? m_worldSize.x : m_worldSize.y;
+        if (2.f * h >= w) c = w / 2.f;
+        else              c = std::clamp(c, h, w - h);
+    }
+    m_view.setCenter(center);
+}
+
+sf::FloatRect Camera::getVisibleRect() const {
+    sf::Vector2f size = m_view.getSize();
+    sf::Vector2f center = m_view.getCenter();
+    return sf::FloatRect(center.x - size.x / 2.f, center.y - size.y / 2.f, size.x, size.y);
+}
+
+LodLevel Camera::getLod() const {
+    if (m_zoom >= LOD_IMPOSTOR_ZOOM) return LodLevel::IMPOSTOR;
+    if (m_zoom >= LOD_NO_HUD_ZOOM)   return LodLevel::NO_HUD;
+    return LodLevel::FULL;
+}
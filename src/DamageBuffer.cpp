@@ -0,0 +1,84 @@
+#include "DamageBuffer.h"
+#include "Unit.h"
+#include <atomic>
+
+namespace {
+    std::atomic<std::uint64_t> s_nextSerial{ 1 };
+
+    // 每个线程记住自己最近一次用的缓冲区 (绝大多数情况下整局只有一个 DamageBuffer)
+    // 没命中时回到实例里按线程 id 查找，不会重复登记
+    struct LocalCache {
+        std::uint64_t owner = 0;
+        std::vector<DamageEvent>* buffer = nullptr;
+    };
+    thread_local LocalCache t_cache;
+}
+
+DamageBuffer::DamageBuffer(const UnitHandleTable& units)
+    : m_units(units), m_serial(s_nextSerial++) {}
+
+std::vector<DamageEvent>& DamageBuffer::local() {
+    if (t_cache.owner != m_serial) {
+        std::thread::id self = std::this_thread::get_id();
+        std::lock_guard<std::mutex> lock(m_registerMutex);
+        std::vector<DamageEvent>* buffer = nullptr;
+        for (const ThreadBuffer& b : m_buffers) {
+            if (b.thread == self) {
+                buffer = b.events.get();
+                break;
+            }
+        }
+        if (!buffer) {
+            m_buffers.push_back(ThreadBuffer{ self, std::make_unique<std::vector<DamageEvent>>() });
+            buffer = m_buffers.back().events.get();
+        }
+        t_cache.owner = m_serial;
+        t_cache.buffer = buffer;
+    }
+    return *t_cache.buffer;
+}
+
+void DamageBuffer::submit(const Unit* target, float amount) {
+    if (!target || amount <= 0.f) return;
+    local().push_back(DamageEvent{ target->getHandle(), amount });
+}
+
+int DamageBuffer::resolve() {
+    m_lastEvents = 0;
+    m_touchedList.clear();
+
+    // 1. 按目标汇总
+    for (ThreadBuffer& b : m_buffers) {
+        std::vector<DamageEvent>& buffer = *b.events;
+        m_lastEvents += buffer.size();
+        for (const DamageEvent& e : buffer) {
+            Unit* unit = m_units.get(e.target);
+            if (!unit) continue; // 目标已经被删除
+            std::uint32_t index = e.target.index;
+            if (index >= m_total.size()) {
+                m_total.resize(index + 1, 0.f);
+                m_touched.resize(index + 1, 0);
+            }
+            if (!m_touched[index]) {
+                m_touched[index] = 1;
+                m_touchedList.push_back(Touched{ index, unit });
+            }
+            m_total[index] += unit->mitigate(e.amount);
+        }
+        buffer.clear(); // 保留容量
+    }
+
+    // 2. 每个目标写一次
+    int deaths = 0;
+    for (const Touched& t : m_touchedList) {
+        std::uint32_t index = t.index;
+        Unit* unit = t.unit;
+        bool wasAlive = unit->isAlive();
+        unit->applyDamage(m_total[index]);
+        if (wasAlive && unit->isDead()) deaths++;
+        m_total[index] = 0.f;
+        m_touched[index] = 0;
+    }
+    m_lastTargets = m_touchedList.size();
+    return deaths;
+}
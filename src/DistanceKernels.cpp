@@ -0,0 +1,290 @@
+#include "DistanceKernels.h"
+#include <cmath>
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define BATTLESIM_X86_64 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC/Clang 用函数级 target 属性单独打开 AVX2，整个工程不需要 -mavx2；MSVC 直接可用
+#if defined(BATTLESIM_X86_64) && (defined(__GNUC__) || defined(__clang__))
+#define BATTLESIM_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define BATTLESIM_TARGET_AVX2
+#endif
+
+namespace DistanceKernels {
+
+namespace {
+    // 最低置位的位置 (调用方保证 x != 0)
+    int lowestBit(unsigned x) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, x);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctz(x);
+#endif
+    }
+
+    // 初始 "最好距离" 取 maxDist2 的下一个浮点数，这样严格小于比较也能选中正好在半径上的候选
+    float initialBest(float maxDist2) {
+        return std::nextafter(maxDist2, std::numeric_limits<float>::infinity());
+    }
+
+    // ---------------- 标量 ----------------
+
+    int nearestScalar(const float* xs, const float* ys, int count, float px, float py, float maxDist2, float* outDist2) {
+        float best = initialBest(maxDist2);
+        int bestIndex = -1;
+        for (int i = 0; i < count; ++i) {
+            float dx = xs[i] - px;
+            float dy = ys[i] - py;
+            float d = dx * dx + dy * dy;
+            if (d < best) {
+                best = d;
+                bestIndex = i;
+            }
+        }
+        if (outDist2 && bestIndex >= 0) *outDist2 = best;
+        return bestIndex;
+    }
+
+    int withinScalar(const float* xs, const float* ys, int count, float px, float py, float radius2, int* out) {
+        int n = 0;
+        for (int i = 0; i < count; ++i) {
+            float dx = xs[i] - px;
+            float dy = ys[i] - py;
+            if (dx * dx + dy * dy <= radius2) out[n++] = i;
+        }
+        return n;
+    }
+
+#ifdef BATTLESIM_X86_64
+    // 各通道的最小值合并：距离最小的胜出，距离相同取下标小的 (与标量版选 "第一个最小" 一致)
+    int reduceLanes(const float* d, const int* idx, int lanes, float& best) {
+        int bestIndex = -1;
+        for (int l = 0; l < lanes; ++l) {
+            if (idx[l] < 0) continue;
+            if (d[l] < best || (d[l] == best && bestIndex >= 0 && idx[l] < bestIndex)) {
+                best = d[l];
+                bestIndex = idx[l];
+            }
+        }
+        return bestIndex;
+    }
+
+    // 向量循环剩下的尾部 [begin, count)，写出的是原数组下标
+    int withinTail(const float* xs, const float* ys, int begin, int count, float px, float py, float radius2, int* out) {
+        int n = 0;
+        for (int i = begin; i < count; ++i) {
+            float dx = xs[i] - px;
+            float dy = ys[i] - py;
+            if (dx * dx + dy * dy <= radius2) out[n++] = i;
+        }
+        return n;
+    }
+
+    // ---------------- SSE (4 宽) ----------------
+
+    int nearestSse(const float* xs, const float* ys, int count, float px, float py, float maxDist2, float* outDist2) {
+        const float init = initialBest(maxDist2);
+        const __m128 vx = _mm_set1_ps(px);
+        const __m128 vy = _mm_set1_ps(py);
+        __m128 best = _mm_set1_ps(init);
+        __m128i bestIdx = _mm_set1_epi32(-1);
+        __m128i idx = _mm_setr_epi32(0, 1, 2, 3);
+        const __m128i step = _mm_set1_epi32(4);
+
+        int i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128 dx = _mm_sub_ps(_mm_loadu_ps(xs + i), vx);
+            __m128 dy = _mm_sub_ps(_mm_loadu_ps(ys + i), vy);
+            __m128 d = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+            // SSE2 没有 blend，用与/或拼出选择
+            __m128 lt = _mm_cmplt_ps(d, best);
+            best = _mm_or_ps(_mm_and_ps(lt, d), _mm_andnot_ps(lt, best));
+            __m128i lti = _mm_castps_si128(lt);
+            bestIdx = _mm_or_si128(_mm_and_si128(lti, idx), _mm_andnot_si128(lti, bestIdx));
+            idx = _mm_add_epi32(idx, step);
+        }
+
+        alignas(16) float d[4];
+        alignas(16) int id[4];
+        _mm_store_ps(d, best);
+        _mm_store_si128(reinterpret_cast<__m128i*>(id), bestIdx);
+        float bestD = init;
+        int bestIndex = reduceLanes(d, id, 4, bestD);
+
+        // 尾部不足 4 个的用标量补完 (下标更大，严格小于即可保持 "第一个最小")
+        for (; i < count; ++i) {
+            float dx = xs[i] - px;
+            float dy = ys[i] - py;
+            float dd = dx * dx + dy * dy;
+            if (dd < bestD) {
+                bestD = dd;
+                bestIndex = i;
+            }
+        }
+        if (outDist2 && bestIndex >= 0) *outDist2 = bestD;
+        return bestIndex;
+    }
+
+    int withinSse(const float* xs, const float* ys, int count, float px, float py, float radius2, int* out) {
+        const __m128 vx = _mm_set1_ps(px);
+        const __m128 vy = _mm_set1_ps(py);
+        const __m128 vr = _mm_set1_ps(radius2);
+        int n = 0;
+        int i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128 dx = _mm_sub_ps(_mm_loadu_ps(xs + i), vx);
+            __m128 dy = _mm_sub_ps(_mm_loadu_ps(ys + i), vy);
+            __m128 d = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_ps(_mm_cmple_ps(d, vr)));
+            while (mask) {
+                out[n++] = i + lowestBit(mask);
+                mask &= mask - 1;
+            }
+        }
+        return n + withinTail(xs, ys, i, count, px, py, radius2, out + n);
+    }
+
+    // ---------------- AVX2 (8 宽) ----------------
+
+    BATTLESIM_TARGET_AVX2
+    int nearestAvx2(const float* xs, const float* ys, int count, float px, float py, float maxDist2, float* outDist2) {
+        const float init = initialBest(maxDist2);
+        const __m256 vx = _mm256_set1_ps(px);
+        const __m256 vy = _mm256_set1_ps(py);
+        __m256 best = _mm256_set1_ps(init);
+        __m256i bestIdx = _mm256_set1_epi32(-1);
+        __m256i idx = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        const __m256i step = _mm256_set1_epi32(8);
+
+        int i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(xs + i), vx);
+            __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(ys + i), vy);
+            __m256 d = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+            __m256 lt = _mm256_cmp_ps(d, best, _CMP_LT_OQ);
+            best = _mm256_blendv_ps(best, d, lt);
+            bestIdx = _mm256_blendv_epi8(bestIdx, idx, _mm256_castps_si256(lt));
+            idx = _mm256_add_epi32(idx, step);
+        }
+
+        alignas(32) float d[8];
+        alignas(32) int id[8];
+        _mm256_store_ps(d, best);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(id), bestIdx);
+        float bestD = init;
+        int bestIndex = reduceLanes(d, id, 8, bestD);
+
+        for (; i < count; ++i) {
+            float dx = xs[i] - px;
+            float dy = ys[i] - py;
+            float dd = dx * dx + dy * dy;
+            if (dd < bestD) {
+                bestD = dd;
+                bestIndex = i;
+            }
+        }
+        if (outDist2 && bestIndex >= 0) *outDist2 = bestD;
+        return bestIndex;
+    }
+
+    BATTLESIM_TARGET_AVX2
+    int withinAvx2(const float* xs, const float* ys, int count, float px, float py, float radius2, int* out) {
+        const __m256 vx = _mm256_set1_ps(px);
+        const __m256 vy = _mm256_set1_ps(py);
+        const __m256 vr = _mm256_set1_ps(radius2);
+        int n = 0;
+        int i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(xs + i), vx);
+            __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(ys + i), vy);
+            __m256 d = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(d, vr, _CMP_LE_OQ)));
+            while (mask) {
+                out[n++] = i + lowestBit(mask);
+                mask &= mask - 1;
+            }
+        }
+        return n + withinTail(xs, ys, i, count, px, py, radius2, out + n);
+    }
+
+    bool cpuHasAvx2() {
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuidex(info, 7, 0);
+        bool avx2 = (info[1] & (1 << 5)) != 0;
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        // 操作系统要保存 YMM 寄存器才能用
+        return avx2 && osxsave && (_xgetbv(0) & 0x6) == 0x6;
+#else
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+#endif // BATTLESIM_X86_64
+
+    using NearestFn = int (*)(const float*, const float*, int, float, float, float, float*);
+    using WithinFn = int (*)(const float*, const float*, int, float, float, float, int*);
+
+    struct Dispatch {
+        Isa isa;
+        NearestFn nearest;
+        WithinFn within;
+    };
+
+    Isa bestSupported() {
+#ifdef BATTLESIM_X86_64
+        return cpuHasAvx2() ? Isa::AVX2 : Isa::SSE;
+#else
+        return Isa::SCALAR;
+#endif
+    }
+
+    Dispatch makeDispatch(Isa isa) {
+        // 请求的指令集不可用时降一档
+        Isa supported = bestSupported();
+        if (static_cast<int>(isa) > static_cast<int>(supported)) isa = supported;
+        switch (isa) {
+#ifdef BATTLESIM_X86_64
+            case Isa::AVX2: return { Isa::AVX2, nearestAvx2, withinAvx2 };
+            case Isa::SSE:  return { Isa::SSE, nearestSse, withinSse };
+#endif
+            default:        return { Isa::SCALAR, nearestScalar, withinScalar };
+        }
+    }
+
+    Dispatch& dispatch() {
+        static Dispatch d = makeDispatch(bestSupported());
+        return d;
+    }
+}
+
+Isa activeIsa() { return dispatch().isa; }
+
+void setIsa(Isa isa) { dispatch() = makeDispatch(isa); }
+
+const char* isaName(Isa isa) {
+    switch (isa) {
+        case Isa::AVX2: return "avx2";
+        case Isa::SSE:  return "sse";
+        default:        return "scalar";
+    }
+}
+
+int nearest(const float* xs, const float* ys, int count, float px, float py, float maxDist2, float* outDist2) {
+    return dispatch().nearest(xs, ys, count, px, py, maxDist2, outDist2);
+}
+
+int withinRadius(const float* xs, const float* ys, int count, float px, float py, float radius2, int* outIndices) {
+    return dispatch().within(xs, ys, count, px, py, radius2, outIndices);
+}
+
+} // namespace DistanceKernels
@@ -0,0 +1,97 @@
+#include "FrameArena.h"
+#include <algorithm>
+#include <new>
+
+namespace {
+    void* heapAllocate(std::size_t bytes, std::size_t alignment) {
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            return ::operator new(bytes, std::align_val_t(alignment));
+        }
+        return ::operator new(bytes);
+    }
+
+    void heapFree(void* p, std::size_t alignment) {
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            ::operator delete(p, std::align_val_t(alignment));
+        } else {
+            ::operator delete(p);
+        }
+    }
+}
+
+FrameArena::FrameArena(std::size_t capacity)
+    : m_buffer(static_cast<std::byte*>(::operator new(capacity))), m_capacity(capacity),
+      m_offset(0), m_overflowBytes(0), m_peak(0), m_overflows(0) {
+    m_overflow.reserve(16);
+}
+
+FrameArena::~FrameArena() {
+    releaseOverflow(0);
+    ::operator delete(m_buffer);
+}
+
+FrameArena& FrameArena::forThread() {
+    thread_local FrameArena arena;
+    return arena;
+}
+
+void* FrameArena::do_allocate(std::size_t bytes, std::size_t alignment) {
+    // 按对齐要求把当前位置向上取整
+    std::uintptr_t base = reinterpret_cast<std::uintptr_t>(m_buffer);
+    std::uintptr_t aligned = (base + m_offset + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+    std::size_t begin = static_cast<std::size_t>(aligned - base);
+
+    void* p;
+    if (begin + bytes <= m_capacity) {
+        m_offset = begin + bytes;
+        p = m_buffer + begin;
+    } else {
+        // 主缓冲用完了：这一帧先向堆借，reset 时再扩容
+        p = heapAllocate(bytes, alignment);
+        m_overflow.push_back(Overflow{ p, bytes, alignment });
+        m_overflowBytes += bytes;
+        m_overflows++;
+    }
+    m_peak = std::max(m_peak, used());
+    return p;
+}
+
+void FrameArena::do_deallocate(void* p, std::size_t bytes, std::size_t) {
+    // 只有最后一次分配能真正退回 (容器扩容时旧数组常常正好是它)，其余等帧末统一收回
+    if (static_cast<std::byte*>(p) + bytes == m_buffer + m_offset) {
+        m_offset = static_cast<std::size_t>(static_cast<std::byte*>(p) - m_buffer);
+    }
+}
+
+bool FrameArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+void FrameArena::releaseOverflow(std::size_t keep) {
+    while (m_overflow.size() > keep) {
+        const Overflow& block = m_overflow.back();
+        m_overflowBytes -= block.bytes;
+        heapFree(block.data, block.alignment);
+        m_overflow.pop_back();
+    }
+}
+
+void FrameArena::rewind(std::size_t offset, std::size_t overflowCount) {
+    // 只退位置和溢出块：峰值要留到帧末的 reset() 统计和扩容，帧中途清零会让峰值只剩最后一段
+    releaseOverflow(overflowCount);
+    if (offset < m_offset) m_offset = offset;
+}
+
+void FrameArena::reset() {
+    // 本帧溢出过：主缓冲扩到峰值的 1.5 倍 (至少翻倍)，下一帧同样的用量就装得下了
+    if (m_peak > m_capacity) {
+        std::size_t capacity = std::max(m_capacity * 2, m_peak + m_peak / 2);
+        releaseOverflow(0);
+        ::operator delete(m_buffer);
+        m_buffer = static_cast<std::byte*>(::operator new(capacity));
+        m_capacity = capacity;
+    }
+    releaseOverflow(0);
+    m_offset = 0;
+    m_peak = 0;
+}
@@ -2,59 +2,63 @@
 #include <iostream>
 #include "Unit.h"
 #include "Tower.h"
-#include "Projectile.h"
 #include <chrono> // 用于线程休眠
 #include <iomanip> // 用于保留小数
-#include <sstream>
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
 #include "ResourceManager.h"
-
-// =================== 游戏配置区域 (修改这里即可调整地图布局) ===================
-namespace Config {
-    // 地图左右边界 (山脉) 的列号
-    // 任何在此列的格子都会变成山脉，阻挡单位
-    const int MAP_BOUNDARY_COL_LEFT = 5;
-    const int MAP_BOUNDARY_COL_RIGHT = 15;
-
-    // 网格坐标 (列 Col, 行 Row)
-    // Team A (敌方/上方)
-    const sf::Vector2i POS_KING_A(10, 2);      // 国王塔
-    const sf::Vector2i POS_PRINCESS_A_L(7, 4); // 左公主塔
-    const sf::Vector2i POS_PRINCESS_A_R(13, 4); // 右公主塔
-
-    // Team B (玩家/下方)
-    const sf::Vector2i POS_KING_B(10, 16);      // 国王塔
-    const sf::Vector2i POS_PRINCESS_B_L(7, 14); // 左公主塔
-    const sf::Vector2i POS_PRINCESS_B_R(13, 14); // 右公主塔
-
-    // 桥梁位置
-    const int BRIDGE_ROW = 9;
-    const int BRIDGE_COL_L = 7;
-    const int BRIDGE_COL_R = 13;
-
-    // 辅助：将网格转为世界坐标 (像素)
-    sf::Vector2f toWorld(sf::Vector2i gridPos) {
+#include "AudioMixer.h"
+#include "FrameArena.h"
+#include "HeapStats.h"
+#include "Profiler.h"
+
+namespace {
+    // 辅助：将网格 (行, 列) 转为格子中心的世界坐标 (像素)
+    sf::Vector2f cellToWorld(int row, int col) {
         return sf::Vector2f(
-            gridPos.x * Game::TILE_SIZE + Game::TILE_SIZE / 2.0f,
-            gridPos.y * Game::TILE_SIZE + Game::TILE_SIZE / 2.0f
+            col * Game::TILE_SIZE + Game::TILE_SIZE / 2.0f,
+            row * Game::TILE_SIZE + Game::TILE_SIZE / 2.0f
         );
     }
 }
-// ===========================================================================
 
-Game::Game() 
-    : m_running(false) , m_selectedCardIndex(-1),
+Game::Game(MapData map, bool headless) 
+    : m_map(std::move(map)), m_damage(m_unitHandles),
+    m_heapTickAllocs(0), m_heapWindowAllocs(0), m_heapWindowMax(0), m_arenaWindowPeak(0), m_heapWindowTicks(0),
+    m_projectiles(m_unitHandles, m_damage), m_isDragging(false), m_impostors(sf::Quads), m_gameOver(false),
     m_elixir(5.0f), m_maxElixir(10.0f), m_elixirRate(0.7f), // 初始5费，上限10费，每秒回0.7费
-    m_enemyElixir(5.0f), m_enemyMaxElixir(10.0f),m_aiThinkTimer(0.f)
+    m_selectedCardIndex(-1),
+    m_enemyElixir(5.0f), m_enemyMaxElixir(10.0f), m_aiThinkTimer(0.f), m_aiEnabled(true),
+    m_running(false)
     {
-    // 1. 加载资源
-    ResourceManager::getInstance().loadAllAssets(); // 加载所有资源
-
-    // 2. 初始化窗口和地图
-    initWindow();
-    initMap();
-    initUI();
+    // 0. 地图由调用方载入 (见 MapFile)，窗口大小和摄像机范围都依赖它的尺寸
+    m_spatialGrid.resize(m_map.tiles.rows(), m_map.tiles.cols());
+
+    // 事件订阅要在放置任何塔和单位之前完成
+    m_towerRegistry.attach(m_eventBus);
+    m_unitHandles.attach(m_eventBus);
+    m_eventBus.subscribe(GameEventType::TOWER_DESTROYED, [this](const GameEvent& e) {
+        onTowerDestroyed(static_cast<Tower*>(e.unit));
+    });
+
+    if (!headless) {
+        // 1. 先创建窗口，加载资源时就能显示进度条
+        initWindow();
+
+        // 2. 并行加载资源 (纹理上传完才返回，音频继续在后台加载)
+        loadAssets();
+        // 音频线程：单位只投递音效事件，由混音器统一分配声部
+        AudioMixer::getInstance().start();
+
+        // 3. 初始化地图和 UI
+        initMap();
+        initUI();
+    }
+    // (无窗口时单位的精灵拿到的是空纹理，不影响逻辑；音效事件队列满了就丢)
     initTowers(); // 先初始化塔
     initUnits(); // 初始化单位
+    rebuildSpatialGrid(); // 第一帧渲染前就需要网格
 
     // 默认设置普通难度
     setDifficulty(Difficulty::NORMAL);
@@ -66,6 +70,7 @@ Game::~Game() {
     if (m_logicThread.joinable()) {
         m_logicThread.join();
     }
+    AudioMixer::getInstance().stop();
 
     // 2. 清理内存
     for (auto unit : m_units) {
@@ -73,8 +78,6 @@ Game::~Game() {
     }
     m_units.clear();
 
-    // 清理子弹内存
-    //不需要手动 delete Projectiles 了，ObjectPool 的析构函数会处理
     m_projectiles.clear();
 }
 
@@ -107,29 +110,65 @@ void Game::setDifficulty(Difficulty level) {
 }
 
 void Game::initWindow() {
+    // 地图的实际像素大小
+    int mapWidth = m_map.tiles.cols() * TILE_SIZE;
+    int mapHeight = m_map.tiles.rows() * TILE_SIZE;
+
     // 根据地图大小动态计算窗口分辨率
-    int width = COLS * TILE_SIZE;
-    int height = ROWS * TILE_SIZE + UI_HEIGHT; // 增加UI高度
+    // 地图太大时窗口只显示一部分，其余靠摄像机滚动/缩放查看
+    int width = std::min(mapWidth, MAX_VIEW_WIDTH);
+    int viewHeight = std::min(mapHeight, MAX_VIEW_HEIGHT);
+    int height = viewHeight + UI_HEIGHT; // 增加UI高度
 
     // 创建窗口
     m_window.create(sf::VideoMode(width, height), "Battle Simulation");
     // 设置帧率限制为 60 FPS
     m_window.setFramerateLimit(60);
 
-    // 设置背景图
-    sf::Texture& bgTexture = ResourceManager::getInstance().getTexture("background");
-    m_bgSprite.setTexture(bgTexture);
+    // 摄像机只管地图区域，UI 用窗口默认视图绘制
+    m_camera.init(sf::Vector2f(mapWidth, mapHeight), sf::Vector2f(width, viewHeight), m_window.getSize());
+}
 
-    // 计算缩放比例，让背景图完全适应窗口大小
-    float scaleX = static_cast<float>(width) / bgTexture.getSize().x;
-    float scaleY = static_cast<float>(height) / bgTexture.getSize().y;
-    m_bgSprite.setScale(scaleX, scaleY);
+void Game::loadAssets() {
+    ResourceManager& rm = ResourceManager::getInstance();
+    rm.startAsyncLoad();
+
+    // 启动进度条：纯色块，不依赖任何还没加载的资源
+    float windowWidth = m_window.getSize().x;
+    float windowHeight = m_window.getSize().y;
+    sf::Vector2f barSize(windowWidth * 0.6f, 24.f);
+    sf::Vector2f barPos((windowWidth - barSize.x) / 2.f, windowHeight / 2.f);
+
+    sf::RectangleShape barBg(barSize);
+    barBg.setPosition(barPos);
+    barBg.setFillColor(sf::Color(20, 20, 20));
+    barBg.setOutlineThickness(2.f);
+    barBg.setOutlineColor(sf::Color(200, 200, 200));
+
+    sf::RectangleShape barFg;
+    barFg.setPosition(barPos);
+    barFg.setFillColor(sf::Color(255, 0, 255)); // 和圣水条同色
+
+    // 主线程一边上传已解码的纹理，一边刷新进度条
+    while (!rm.pumpUploads()) {
+        sf::Event event;
+        while (m_window.pollEvent(event)) {
+            // 加载中关窗：让加载跑完，run() 看到窗口已关闭会直接退出
+            if (event.type == sf::Event::Closed) m_window.close();
+        }
+
+        barFg.setSize(sf::Vector2f(barSize.x * rm.getLoadProgress(), barSize.y));
+        m_window.clear(sf::Color(50, 50, 50));
+        m_window.draw(barBg);
+        m_window.draw(barFg);
+        m_window.display();
+    }
 }
 
 void Game::initUI() {
     // 1. 初始化游戏结束文字
     // 使用引用，防止拷贝
-    sf::Font& font = ResourceManager::getInstance().getFont("main_font");
+    sf::Font& font = ResourceManager::getInstance().getFont(FontId::MAIN);
     m_gameOverText.setFont(font);
     m_gameOverText.setCharacterSize(60);
     m_gameOverText.setFillColor(sf::Color::White);
@@ -138,7 +177,8 @@ void Game::initUI() {
     m_gameOverText.setString(""); // 初始为空
 
     // 2. 初始化 UI 背景底板
-    float mapBottom = ROWS * TILE_SIZE;
+    // UI 固定在窗口底部 (屏幕坐标，不随摄像机移动)
+    float mapBottom = m_window.getSize().y - UI_HEIGHT;
     float windowWidth = m_window.getSize().x;
     
     m_uiBg.setSize(sf::Vector2f(windowWidth, UI_HEIGHT));
@@ -166,7 +206,7 @@ void Game::initUI() {
     m_elixirBarFg.setPosition(barX, barY);
 
     // 圣水图标 (左侧)
-    m_elixirIcon.setTexture(ResourceManager::getInstance().getTexture("ui_elixir"));
+    m_elixirIcon.setTexture(ResourceManager::getInstance().getTexture(TextureId::UI_ELIXIR));
     m_elixirIcon.setScale(0.25f, 0.25f); // 原图可能很大，缩小一下
     m_elixirIcon.setPosition(barX - 35, barY + 2);
 
@@ -175,6 +215,7 @@ void Game::initUI() {
     m_elixirStatusText.setCharacterSize(18);
     m_elixirStatusText.setFillColor(sf::Color::White);
     m_elixirStatusText.setPosition(barX + barWidth + 10, barY);
+    m_elixirShown = -1; // 第一次 renderUI 时设置文字
 
     // 难度显示UI
     m_difficultyText.setFont(font);
@@ -184,20 +225,20 @@ void Game::initUI() {
     m_difficultyText.setOutlineThickness(1.5f);
 
     // 3. 初始化卡牌列表
-    // 定义我们要添加的卡牌数据 (类型, 费用, 图标key)
+    // 定义我们要添加的卡牌数据 (类型, 费用, 图标句柄)
     struct CardData {
         UnitType type;
         int cost;
-        std::string iconKey;
+        TextureId icon;
     };
 
     std::vector<CardData> initialCards = {
-        { UnitType::KNIGHT, 3, "icon_knight" },
-        { UnitType::ARCHERS, 3, "icon_archers" },
-        { UnitType::GIANT, 5, "icon_giant" },
-        { UnitType::PEKKA, 7, "icon_pekka" },
-        { UnitType::VALKYRIE, 4, "icon_valkyrie" },
-        { UnitType::DART_GOBLIN, 3, "icon_dartgoblin" }
+        { UnitType::KNIGHT, 3, TextureId::ICON_KNIGHT },
+        { UnitType::ARCHERS, 3, TextureId::ICON_ARCHERS },
+        { UnitType::GIANT, 5, TextureId::ICON_GIANT },
+        { UnitType::PEKKA, 7, TextureId::ICON_PEKKA },
+        { UnitType::VALKYRIE, 4, TextureId::ICON_VALKYRIE },
+        { UnitType::DART_GOBLIN, 3, TextureId::ICON_DARTGOBLIN }
     };
 
     // 计算卡牌布局
@@ -223,7 +264,7 @@ void Game::initUI() {
         newCard.slotShape.setPosition(currentX, startY);
 
         // 设置卡牌图标
-        newCard.sprite.setTexture(ResourceManager::getInstance().getTexture(initialCards[i].iconKey));
+        newCard.sprite.setTexture(ResourceManager::getInstance().getTexture(initialCards[i].icon));
         // 适配大小
         sf::FloatRect bounds = newCard.sprite.getLocalBounds();
         newCard.sprite.setScale(cardWidth / bounds.width, cardHeight / bounds.height);
@@ -248,68 +289,39 @@ void Game::initUI() {
 
         m_deck.push_back(newCard);
     }
+
+    // 圣水不够时的卡牌遮罩 (位置大小在 renderUI 里按卡槽设置)
+    m_cardMask.setFillColor(sf::Color(0, 0, 0, 150)); // 半透明黑
+    m_cardMask.setOutlineThickness(0);
 }
 
 void Game::initMap() {
-    // 1. 全部重置为平地
-    m_mapData.assign(ROWS, std::vector<int>(COLS, GROUND));
-
-    // 使用 Config 设置河流与桥梁
-    int riverRow = Config::BRIDGE_ROW;
-    for (int c = 0; c < COLS; c++) m_mapData[riverRow][c] = RIVER;
-    m_mapData[riverRow][Config::BRIDGE_COL_L] = BRIDGE;
-    m_mapData[riverRow][Config::BRIDGE_COL_R] = BRIDGE;
-
-    // 使用 Config 设置基地位置标记
-    m_mapData[Config::POS_KING_A.y][Config::POS_KING_A.x] = BASE_A;
-    m_mapData[Config::POS_PRINCESS_A_L.y][Config::POS_PRINCESS_A_L.x] = BASE_A;
-    m_mapData[Config::POS_PRINCESS_A_R.y][Config::POS_PRINCESS_A_R.x] = BASE_A;
-
-    m_mapData[Config::POS_KING_B.y][Config::POS_KING_B.x] = BASE_B;
-    m_mapData[Config::POS_PRINCESS_B_L.y][Config::POS_PRINCESS_B_L.x] = BASE_B;
-    m_mapData[Config::POS_PRINCESS_B_R.y][Config::POS_PRINCESS_B_R.x] = BASE_B;
-
-    // 使用 Config 中定义的边界，而不是硬编码的数字
-    for (int r = 0; r < ROWS; r++) { 
-        // 设置左边界
-        if (Config::MAP_BOUNDARY_COL_LEFT >= 0 && Config::MAP_BOUNDARY_COL_LEFT < COLS) {
-            m_mapData[r][Config::MAP_BOUNDARY_COL_LEFT] = MOUNTAIN; 
-        }
-        // 设置右边界
-        if (Config::MAP_BOUNDARY_COL_RIGHT >= 0 && Config::MAP_BOUNDARY_COL_RIGHT < COLS) {
-            m_mapData[r][Config::MAP_BOUNDARY_COL_RIGHT] = MOUNTAIN; 
-        }
-    }
+    // 地形、塔位、部署区和进攻路线都来自地图文件 (见 MapFile.h)
+    // 这里只负责背景图
+    int rows = m_map.tiles.rows();
+    int cols = m_map.tiles.cols();
 
-     // 初始化空间划分网格
-    // 大小 = 总行数 * 总列数
-    m_spatialGrid.resize(ROWS * COLS);
+    // 设置背景图
+    sf::Texture& bgTexture = ResourceManager::getInstance().getTexture(TextureId::BACKGROUND);
+    m_bgSprite.setTexture(bgTexture);
+
+    // 计算缩放比例，让背景图铺满整张地图 (世界坐标)
+    float scaleX = static_cast<float>(cols * TILE_SIZE) / bgTexture.getSize().x;
+    float scaleY = static_cast<float>(rows * TILE_SIZE) / bgTexture.getSize().y;
+    m_bgSprite.setScale(scaleX, scaleY);
 
     std::cout << "[Info] Map initialized." << std::endl;
 }
 
 // 根据地图生成塔对象
 void Game::initTowers() {
-    // 使用 Config 初始化塔
-    // Team A
-    sf::Vector2f kA = Config::toWorld(Config::POS_KING_A);
-    m_units.push_back(new Tower(kA.x, kA.y, TEAM_A, TowerType::KING));
-    
-    sf::Vector2f pAL = Config::toWorld(Config::POS_PRINCESS_A_L);
-    m_units.push_back(new Tower(pAL.x, pAL.y, TEAM_A, TowerType::PRINCESS));
-    
-    sf::Vector2f pAR = Config::toWorld(Config::POS_PRINCESS_A_R);
-    m_units.push_back(new Tower(pAR.x, pAR.y, TEAM_A, TowerType::PRINCESS));
-
-    // Team B
-    sf::Vector2f kB = Config::toWorld(Config::POS_KING_B);
-    m_units.push_back(new Tower(kB.x, kB.y, TEAM_B, TowerType::KING));
-
-    sf::Vector2f pBL = Config::toWorld(Config::POS_PRINCESS_B_L);
-    m_units.push_back(new Tower(pBL.x, pBL.y, TEAM_B, TowerType::PRINCESS));
-
-    sf::Vector2f pBR = Config::toWorld(Config::POS_PRINCESS_B_R);
-    m_units.push_back(new Tower(pBR.x, pBR.y, TEAM_B, TowerType::PRINCESS));
+    // 按地图文件里的塔位生成
+    for (const auto& t : m_map.towers) {
+        sf::Vector2f pos = cellToWorld(t.row, t.col);
+        Tower* tower = new Tower(pos.x, pos.y, static_cast<Team>(t.team), t.king ? TowerType::KING : TowerType::PRINCESS);
+        m_units.push_back(tower);
+        m_eventBus.publish({ GameEventType::UNIT_SPAWNED, tower });
+    }
 }
 
 void Game::initUnits() {
@@ -317,6 +329,7 @@ void Game::initUnits() {
 }
 
 void Game::run() {
+    PROFILE_THREAD("main");
     // 启动逻辑线程
     m_running = true;
     m_logicThread = std::thread(&Game::logicLoop, this);
@@ -335,6 +348,7 @@ void Game::run() {
 }
 
 void Game::logicLoop() {
+    PROFILE_THREAD("logic");
     sf::Clock clock;
     while (m_running) {
         // 计算 Delta Time
@@ -366,18 +380,50 @@ void Game::processEvents() {
             }
         }
 
+        // 右键/中键拖拽地图
+        if (event.type == sf::Event::MouseButtonPressed) {
+            if (event.mouseButton.button == sf::Mouse::Right || event.mouseButton.button == sf::Mouse::Middle) {
+                m_isDragging = true;
+                m_lastMousePos = sf::Vector2i(event.mouseButton.x, event.mouseButton.y);
+            }
+        }
+        if (event.type == sf::Event::MouseButtonReleased) {
+            if (event.mouseButton.button == sf::Mouse::Right || event.mouseButton.button == sf::Mouse::Middle) {
+                m_isDragging = false;
+            }
+        }
+        if (event.type == sf::Event::MouseMoved && m_isDragging) {
+            sf::Vector2i pos(event.mouseMove.x, event.mouseMove.y);
+            m_camera.panPixels(sf::Vector2f(m_lastMousePos - pos));
+            m_lastMousePos = pos;
+        }
+
+        // 滚轮缩放 (以鼠标所指的位置为中心)
+        if (event.type == sf::Event::MouseWheelScrolled &&
+            event.mouseWheelScroll.wheel == sf::Mouse::VerticalWheel) {
+            sf::Vector2i pixel(event.mouseWheelScroll.x, event.mouseWheelScroll.y);
+            if (pixel.y < static_cast<int>(m_window.getSize().y) - UI_HEIGHT) {
+                sf::Vector2f anchor = m_window.mapPixelToCoords(pixel, m_camera.getView());
+                float factor = (event.mouseWheelScroll.delta > 0) ? (1.f / 1.15f) : 1.15f;
+                m_camera.zoomAt(factor, anchor);
+            }
+        }
+
         // 键盘事件：调节难度
         if (event.type == sf::Event::KeyPressed) {
             if (event.key.code == sf::Keyboard::Num1) setDifficulty(Difficulty::EASY);
             if (event.key.code == sf::Keyboard::Num2) setDifficulty(Difficulty::NORMAL);
             if (event.key.code == sf::Keyboard::Num3) setDifficulty(Difficulty::HARD);
+            if (event.key.code == sf::Keyboard::Home) m_camera.reset(); // 摄像机归位
+            if (event.key.code == sf::Keyboard::F9) Profiler::printSummary(std::cout); // 各阶段耗时汇总
         }
     }
 }
 
 // 【新增】处理点击逻辑
 void Game::handleMouseClick(int x, int y) {
-    float mapHeight = ROWS * TILE_SIZE;
+    // 地图区域在窗口中的高度 (UI 以下)
+    float mapHeight = m_window.getSize().y - UI_HEIGHT;
 
     // 1. 如果点击的是 UI 区域 (底部)
     if (y > mapHeight) {
@@ -412,23 +458,25 @@ void Game::handleMouseClick(int x, int y) {
             // 可以在这里播放一个“错误提示音”
             return; // 直接返回，不生成，不扣费
         }
+        // 屏幕坐标 -> 世界坐标 (经过摄像机的平移和缩放)
+        sf::Vector2f world = m_window.mapPixelToCoords(sf::Vector2i(x, y), m_camera.getView());
+
         // 计算网格坐标
-        int col = x / TILE_SIZE;
-        int row = y / TILE_SIZE;
+        int col = static_cast<int>(std::floor(world.x / TILE_SIZE));
+        int row = static_cast<int>(std::floor(world.y / TILE_SIZE));
 
         // 合法性检查：
         // A. 是否越界
-        if (row < 0 || row >= ROWS || col < 0 || col >= COLS) return;
+        if (!m_map.tiles.inBounds(row, col)) return;
         
         // B. 地形检查：不能放在河里(RIVER)或山上(MOUNTAIN)，除非是飞行单位(暂未实现区分)
-        int tileType = m_mapData[row][col];
-        if (tileType == RIVER || tileType == MOUNTAIN) {
+        if (!m_map.tiles.isPassable(row, col)) {
             std::cout << "[Game] Invalid terrain placement!" << std::endl;
             return;
         }
 
         // C. 放置位置检查：只能放在己方半场
-        if (row < Config::BRIDGE_ROW) {
+        if (!m_map.canDeploy(TEAM_B, row, col)) {
              std::cout << "[Game] Can only deploy on your side!" << std::endl;
              return;
         }
@@ -473,24 +521,32 @@ void Game::spawnUnit(UnitType type, float x, float y, int team) {
     }
 
     if (newUnit) {
-        // 使用 Config 获取目标坐标
-        sf::Vector2f targetL, targetR;
-        if (team == TEAM_B) { // 玩家打 AI
-            targetL = Config::toWorld(Config::POS_PRINCESS_A_L);
-            targetR = Config::toWorld(Config::POS_PRINCESS_A_R);
-        } else { // AI 打 玩家
-            targetL = Config::toWorld(Config::POS_PRINCESS_B_L);
-            targetR = Config::toWorld(Config::POS_PRINCESS_B_R);
+        // 选择离出生点最近的己方进攻路线，路线终点就是战略目标
+        const MapLane* lane = nullptr;
+        float bestDist = 0.f;
+        for (const auto& l : m_map.lanes) {
+            if (l.team != team) continue;
+            sf::Vector2f entry = cellToWorld(l.entryRow, l.entryCol);
+            float dx = entry.x - x, dy = entry.y - y;
+            float dist = dx * dx + dy * dy;
+            if (!lane || dist < bestDist) {
+                lane = &l;
+                bestDist = dist;
+            }
         }
-        
-        // 简单的左右路判断
-        if (std::abs(x - targetL.x) < std::abs(x - targetR.x)) {
-            newUnit->setStrategicTarget(targetL.x, targetL.y);
+        if (lane) {
+            sf::Vector2f target = cellToWorld(lane->targetRow, lane->targetCol);
+            newUnit->setStrategicTarget(target.x, target.y);
         } else {
-            newUnit->setStrategicTarget(targetR.x, targetR.y);
+            // 地图没有配置路线：原地待命，只会攻击进入警戒范围的敌人
+            newUnit->setStrategicTarget(x, y);
         }
 
         m_units.push_back(newUnit);
+        // 立即登记到网格，否则在下一次重建前渲染不到它
+        addToSpatialGrid(newUnit);
+        // 塔登记表据此订阅它的目标塔
+        m_eventBus.publish({ GameEventType::UNIT_SPAWNED, newUnit });
     }
 }
 
@@ -512,13 +568,12 @@ void Game::updateAI(float dt) {
     float minThreatDist = 99999.f;
     int threatCount = 0;
 
-    // AI 防守线 (河道上方)
-    float defenseLineY = (Config::BRIDGE_ROW - 2) * TILE_SIZE;
-
     for (auto u : m_units) {
         if (u && !u->isDead() && u->getTeam() == TEAM_B) {
-            // 玩家单位越过河道
-            if (u->getPosition().y < Config::BRIDGE_ROW * TILE_SIZE) {
+            // 玩家单位进入了 AI 的部署区 (越过河道)
+            int col = static_cast<int>(u->getPosition().x) / TILE_SIZE;
+            int row = static_cast<int>(u->getPosition().y) / TILE_SIZE;
+            if (m_map.inDeployZone(TEAM_A, row, col)) {
                 float dist = u->getPosition().y; 
                 if (dist < minThreatDist) {
                     minThreatDist = dist;
@@ -571,9 +626,15 @@ void Game::updateAI(float dt) {
     // --- B. 进攻策略 (无威胁且圣水充裕) ---
     // 如果圣水快满了 (>9)，必须进攻，防止圣水溢出浪费
     else if (m_enemyElixir > 9.0f) {
-        // 随机左右路
-        float bridgeY = (Config::BRIDGE_ROW - 1) * TILE_SIZE; 
-        float bridgeX = (rand() % 2 == 0) ? (Config::BRIDGE_COL_L * TILE_SIZE) : (Config::BRIDGE_COL_R * TILE_SIZE);
+        // 随机选一条己方进攻路线，在路线入口 (桥头) 出兵
+        // 临时列表放在逐帧分配器上，帧末统一收回
+        std::pmr::vector<const MapLane*> lanes(&FrameArena::forThread());
+        for (const auto& l : m_map.lanes) {
+            if (l.team == TEAM_A) lanes.push_back(&l);
+        }
+        if (lanes.empty()) return;
+        const MapLane* lane = lanes[rand() % lanes.size()];
+        sf::Vector2f bridge = cellToWorld(lane->entryRow, lane->entryCol);
                 
         // // 优先放坦克
         // UnitType type = (rand() % 2 == 0) ? UnitType::GIANT : UnitType::PEKKA;
@@ -587,7 +648,7 @@ void Game::updateAI(float dt) {
         UnitType type = (rand() % 2 == 0) ? UnitType::KNIGHT : UnitType::PEKKA;
         int cost = (type == UnitType::KNIGHT) ? 3 : 7;
 
-        spawnUnit(type, bridgeX, bridgeY, TEAM_A);
+        spawnUnit(type, bridge.x, bridge.y, TEAM_A);
         m_enemyElixir -= cost;
         std::cout << "[AI] Attacking bridge with unit type " << (int)type << std::endl;
     }
@@ -597,135 +658,235 @@ void Game::updateAI(float dt) {
 void Game::update(float dt) {
     // 【加锁】因为我们要读取和修改 m_units，渲染线程也在读
     std::lock_guard<std::mutex> lock(m_mutex);
+    const std::uint64_t allocsBefore = HeapStats::threadAllocations();
+    PROFILE_SCOPE("update");
+    PROFILE_PHASES();
 
-    // --- 空间划分优化 (Spatial Partitioning) ---
-    // 步骤 1: 清空每一帧的网格
-    // vector::clear() 保留容量，速度很快
-    for (auto& cell : m_spatialGrid) {
-        cell.clear();
-    }
-
-    // 步骤 2: 将所有活着的单位注册到网格中
-    for (auto unit : m_units) {
-        if (unit && !unit->isDead()) {
-            int c = static_cast<int>(unit->getPosition().x) / TILE_SIZE;
-            int r = static_cast<int>(unit->getPosition().y) / TILE_SIZE;
-
-            // 边界检查，防止越界崩溃
-            if (c >= 0 && c < COLS && r >= 0 && r < ROWS) {
-                int index = r * COLS + c;
-                m_spatialGrid[index].push_back(unit);
-            }
-        }
-    }
+    // 空间网格在上一帧末尾已经重建好 (见 rebuildSpatialGrid)
 
     // 圣水恢复逻辑
+    PROFILE_PHASE("update.elixir");
     if (m_elixir < m_maxElixir) {
         m_elixir += m_elixirRate * dt;
         if (m_elixir > m_maxElixir) m_elixir = m_maxElixir;
     }
 
     // 调用 AI 逻辑
-    if (!m_gameOver) {
+    PROFILE_PHASE("update.ai");
+    if (!m_gameOver && m_aiEnabled) {
         updateAI(dt);
     }
 
+    // 唤醒有敌人靠近 (上一帧网格重建时报警) 或睡够了的单位
+    PROFILE_PHASE("update.activity");
+    m_activity.update(dt, m_spatialGrid);
+
     // 1. 更新所有单位状态 (移动、攻击)
+    PROFILE_PHASE("update.units");
     for (auto unit : m_units) {
-        unit->update(dt, m_spatialGrid, m_projectiles, m_projectilePool,m_mapData);
+        unit->update(dt, m_spatialGrid, m_projectiles, m_damage, m_map.tiles, m_pathScheduler);
+        // 周围没有敌人：休眠，后面几帧跳过索敌
+        if (unit->takeSleepRequest()) m_activity.sleep(unit, m_spatialGrid);
     }
 
-    // 2. 更新所有子弹
-    for (auto proj : m_projectiles) {
-        proj->update(dt);
-    }
+    // 在本帧预算内推进寻路，搜完的结果直接送回单位
+    PROFILE_PHASE("update.paths");
+    m_pathScheduler.update(m_map.tiles);
 
-    // 3. 清理非活跃子弹 (击中目标的)
-    auto projIt = m_projectiles.begin();
-    while (projIt != m_projectiles.end()) {
-        if (!(*projIt)->isActive()) {
-            // 将子弹指针归还给池，而不是 delete
-            m_projectilePool.release(*projIt);
-            // 从活跃列表移除
-            projIt = m_projectiles.erase(projIt);
-        } else {
-            ++projIt;
-        }
-    }
+    // 2. 更新所有子弹，并清理击中目标或目标已失效的
+    PROFILE_PHASE("update.projectiles");
+    m_projectiles.update(dt);
+
+    // 3. 结算本帧提交的全部伤害 (每个目标写一次血量，倒下的在下面清理)
+    PROFILE_PHASE("update.damage");
+    m_damage.resolve();
 
     // 4. 清理尸体
+    PROFILE_PHASE("update.cleanup");
     auto it = m_units.begin();
     while (it != m_units.end()) {
         Unit* u = *it;
         if (u->isDead()) {
-            // 【核心逻辑】检查是否是塔
-            Tower* t = dynamic_cast<Tower*>(u);
-            if (t) {
-                // 1. 生成废墟 Sprite
-                sf::Sprite ruin;
-                ruin.setTexture(ResourceManager::getInstance().getTexture("vfx_damaged"));
-                
-                // 设置废墟位置和原点
-                sf::FloatRect bounds = ruin.getLocalBounds();
-                //ruin.setOrigin(bounds.width / 2.f, bounds.height / 2.f);
-                ruin.setOrigin(bounds.width / 2.f, bounds.height / 2.f);
-                ruin.setPosition(t->getPosition());
-                // 稍微缩放一点以适应格子
-                ruin.setScale(0.3f, 0.3f);
-                
-                m_ruins.push_back(ruin);
-
-                // 2. 检查是否为国王塔 -> 游戏结束
-                if (t->isKing()) {
-                    m_gameOver = true;
-                    if (t->getTeam() == TEAM_A) {
-                        m_gameOverText.setString("Blue Wins!");
-                        m_gameOverText.setFillColor(sf::Color(100, 100, 255));
-                    } else {
-                        m_gameOverText.setString("Red Wins!");
-                        m_gameOverText.setFillColor(sf::Color(255, 60, 60));
-                    }
-                    
-                    // 居中显示文字
-                    sf::FloatRect textRect = m_gameOverText.getLocalBounds();
-                    m_gameOverText.setOrigin(textRect.left + textRect.width/2.0f,
-                                           textRect.top  + textRect.height/2.0f);
-                    m_gameOverText.setPosition(m_window.getSize().x/2.0f, m_window.getSize().y/2.0f);
-                    
-                    std::cout << "[Game] Game Over triggered!" << std::endl;
-                }
-            }
+            // 先发布事件再删除：订阅者 (塔登记表、废墟/胜负判定) 还能读到它
+            m_eventBus.publish({ u->isStructure() ? GameEventType::TOWER_DESTROYED : GameEventType::UNIT_DIED, u });
 
+            m_pathScheduler.cancel(u); // 撤销还没完成的寻路请求
+            m_activity.cancel(u, m_spatialGrid);
             delete u; 
             it = m_units.erase(it); 
         } else {
             ++it;
         }
     }
+
+    // 5. 尸体清理完之后再重建网格
+    // 这样网格里永远没有悬空指针，渲染线程可以放心地用它做裁剪
+    PROFILE_PHASE("update.grid");
+    rebuildSpatialGrid();
+    PROFILE_PHASES_END();
+
+    // 6. 收回本帧的临时分配，统计本帧的堆分配次数
+    FrameArena& arena = FrameArena::forThread();
+    m_arenaWindowPeak = std::max(m_arenaWindowPeak, arena.peak());
+    arena.reset();
+    recordHeapStats(HeapStats::threadAllocations() - allocsBefore);
+}
+
+void Game::recordHeapStats(std::uint64_t tickAllocs) {
+    m_heapTickAllocs = tickAllocs;
+    m_heapWindowAllocs += tickAllocs;
+    m_heapWindowMax = std::max(m_heapWindowMax, tickAllocs);
+    if (++m_heapWindowTicks < HEAP_REPORT_TICKS) return;
+
+    char line[128];
+    std::snprintf(line, sizeof(line), "[Heap] logic thread allocs/tick avg %.2f max %llu | frame arena peak %zu KB / %zu KB",
+                  static_cast<double>(m_heapWindowAllocs) / m_heapWindowTicks,
+                  static_cast<unsigned long long>(m_heapWindowMax),
+                  m_arenaWindowPeak / 1024, FrameArena::forThread().capacity() / 1024);
+    std::cout << line << std::endl;
+    m_heapWindowAllocs = 0;
+    m_heapWindowMax = 0;
+    m_arenaWindowPeak = 0;
+    m_heapWindowTicks = 0;
+}
+
+void Game::onTowerDestroyed(Tower* t) {
+    // 1. 生成废墟 Sprite
+    sf::Sprite ruin;
+    ruin.setTexture(ResourceManager::getInstance().getTexture(TextureId::VFX_DAMAGED));
+    
+    // 设置废墟位置和原点
+    sf::FloatRect bounds = ruin.getLocalBounds();
+    ruin.setOrigin(bounds.width / 2.f, bounds.height / 2.f);
+    ruin.setPosition(t->getPosition());
+    // 稍微缩放一点以适应格子
+    ruin.setScale(0.3f, 0.3f);
+    
+    m_ruins.push_back(ruin);
+
+    // 2. 检查是否为国王塔 -> 游戏结束
+    if (t->isKing()) {
+        m_gameOver = true;
+        if (t->getTeam() == TEAM_A) {
+            m_gameOverText.setString("Blue Wins!");
+            m_gameOverText.setFillColor(sf::Color(100, 100, 255));
+        } else {
+            m_gameOverText.setString("Red Wins!");
+            m_gameOverText.setFillColor(sf::Color(255, 60, 60));
+        }
+        
+        // 居中显示文字
+        sf::FloatRect textRect = m_gameOverText.getLocalBounds();
+        m_gameOverText.setOrigin(textRect.left + textRect.width/2.0f,
+                               textRect.top  + textRect.height/2.0f);
+        m_gameOverText.setPosition(m_window.getSize().x/2.0f, m_window.getSize().y/2.0f);
+        
+        std::cout << "[Game] Game Over triggered!" << std::endl;
+    }
+}
+
+// --- 空间划分优化 (Spatial Partitioning) ---
+void Game::rebuildSpatialGrid() {
+    // 步骤 1: 清空网格
+    // 只重置上一轮占用过的格子，和地图大小无关
+    m_spatialGrid.clear();
+
+    // 步骤 2: 将所有活着的单位注册到网格中
+    for (auto unit : m_units) {
+        if (unit && !unit->isDead()) {
+            addToSpatialGrid(unit);
+        }
+    }
+
+    // 步骤 3: 单位扎堆时把条目按格子的 Z 序排成连续的段，下一帧的邻居查询顺着内存读
+    // 排序要把所有条目搬一遍 (10 万个单位约 2~3 ms)，每格只有一两个单位时查询省下的不够抵
+    if (m_spatialGrid.entryCount() >= GRID_SORT_MIN_LOAD * m_spatialGrid.occupiedCells()) {
+        m_spatialGrid.sortByCell();
+    }
+}
+
+void Game::addToSpatialGrid(Unit* unit) {
+    int c = static_cast<int>(unit->getPosition().x) / TILE_SIZE;
+    int r = static_cast<int>(unit->getPosition().y) / TILE_SIZE;
+
+    // 越界的单位由网格自己忽略，防止越界崩溃
+    m_spatialGrid.insert(unit, r, c);
 }
 
 void Game::render() {
+    // 摄像机平移不涉及共享数据，放在锁外
+    float frameDt = m_frameClock.restart().asSeconds();
+    if (m_window.hasFocus()) {
+        m_camera.update(frameDt);
+    }
+    // 听者跟随摄像机中心，远处的战斗声音更小
+    AudioMixer::getInstance().setListener(m_camera.getView().getCenter());
+
     // 【加锁】我们要读 m_units 来画图，防止读的时候被逻辑线程删掉了
     std::lock_guard<std::mutex> lock(m_mutex);
+    PROFILE_SCOPE("render");
 
     m_window.clear();
 
+    // 1. 地图区域：使用摄像机视图
+    m_window.setView(m_camera.getView());
+    renderWorld(frameDt);
+
+    // 2. UI：切回窗口默认视图，不受摄像机影响
+    m_window.setView(m_window.getDefaultView());
+
+    // 绘制 UI
+    renderUI();
+
+    // 绘制难度文字
+    m_window.draw(m_difficultyText);
+
+    // 绘制游戏结束文字
+    if (m_gameOver) {
+        // 绘制一个半透明背景遮罩，让文字更清晰
+        sf::RectangleShape overlay(sf::Vector2f(m_window.getSize().x, m_window.getSize().y));
+        overlay.setFillColor(sf::Color(0, 0, 0, 150));
+        m_window.draw(overlay);
+        m_window.draw(m_gameOverText);
+    }
+
+    // 3. 显示窗口内容
+    // (display 会等垂直同步/帧率限制，单独计一段，免得把等待算进绘制)
+    PROFILE_SCOPE("render.display");
+    m_window.display();
+}
+
+void Game::renderWorld(float frameDt) {
+    PROFILE_SCOPE("render.world");
+    sf::FloatRect visible = m_camera.getVisibleRect();
+    LodLevel lod = m_camera.getLod();
+
     // 1. 绘制背景图
     m_window.draw(m_bgSprite);
 
+    // 可见的格子范围
+    // 多留两圈：塔和大体型单位的精灵会超出自己所在的格子
+    const int margin = 2;
+    int c0 = std::max(0, static_cast<int>(std::floor(visible.left / TILE_SIZE)) - margin);
+    int c1 = std::min(m_map.tiles.cols() - 1, static_cast<int>(std::floor((visible.left + visible.width) / TILE_SIZE)) + margin);
+    int r0 = std::max(0, static_cast<int>(std::floor(visible.top / TILE_SIZE)) - margin);
+    int r1 = std::min(m_map.tiles.rows() - 1, static_cast<int>(std::floor((visible.top + visible.height) / TILE_SIZE)) + margin);
+
     //2. 绘制半透明网格 (调试用，如果不想看格子可以注释掉这一段)
     //这里我们只绘制 基地、河流和桥梁的调试色块，平地设为透明以便看到背景图
     sf::RectangleShape tileShape(sf::Vector2f(TILE_SIZE, TILE_SIZE));
     tileShape.setOutlineThickness(1.0f);
     tileShape.setOutlineColor(sf::Color(0, 0, 0, 50)); // 极淡的边框
 
-    for (int r = 0; r < ROWS; r++) {
-        for (int c = 0; c < COLS; c++) {
+    for (int r = r0; r <= r1; r++) {
+        for (int c = c0; c <= c1; c++) {
+            TileType type = m_map.tiles.at(r, c);
+
+            // 只有非平地才画出来，平地透明以便看到背景图
+            if (type == GROUND) continue;
+
             tileShape.setPosition(c * TILE_SIZE, r * TILE_SIZE);
-            int type = m_mapData[r][c];
-            
-            // 默认全透明，显示背景图
-            tileShape.setFillColor(sf::Color::Transparent); 
+            tileShape.setFillColor(sf::Color::Transparent);
 
             // 为特殊地形添加半透明遮罩，确认逻辑位置是否对齐
             if (type == RIVER) {
@@ -736,51 +897,70 @@ void Game::render() {
                 tileShape.setFillColor(sf::Color(255, 0, 0, 150)); // 半透明红
             } else if (type == BASE_B) {
                 tileShape.setFillColor(sf::Color(0, 0, 255, 150)); // 半透明蓝
+            } else if (type == MUD) {
+                tileShape.setFillColor(sf::Color(90, 60, 30, 120)); // 半透明深棕
             }
 
-            // 只有非平地才画出来 (或者你可以画所有格子调试)
-            if (type != GROUND) {
-                m_window.draw(tileShape);
-            }
+            m_window.draw(tileShape);
         }
     }
 
     // 绘制废墟 (在单位下方，背景上方)
     for (const auto& ruin : m_ruins) {
-        m_window.draw(ruin);
+        if (visible.intersects(ruin.getGlobalBounds())) {
+            m_window.draw(ruin);
+        }
     }
 
-    // 3. 绘制单位
-    for (auto unit : m_units) {
-        unit->render(m_window);
+    // 3. 绘制单位：只遍历可见范围内的网格，而不是整个 m_units
+    // 这样帧时间只和屏幕上的单位数有关
+    // 动画也在这里推进：屏幕外和远景替身的单位不需要切帧
+    m_impostors.clear();
+    float zoom = m_camera.getZoom();
+
+    for (int r = r0; r <= r1; r++) {
+        for (int c = c0; c <= c1; c++) {
+            for (const SpatialGrid::Entry& entry : m_spatialGrid.cell(r, c)) {
+                Unit* unit = entry.unit;
+                if (lod == LodLevel::FULL) {
+                    unit->updateAnimation(frameDt);
+                    unit->render(m_window);
+                } else if (lod == LodLevel::NO_HUD) {
+                    // 只画精灵，跳过血条
+                    unit->updateAnimation(frameDt);
+                    m_window.draw(unit->getSprite());
+                } else {
+                    // 远景替身：阵营色方块，屏幕上大约固定几个像素大小
+                    // 网格在逻辑帧最后才重建，条目里的位置就是单位当前的位置，不用逐个读单位对象
+                    sf::Vector2f p(entry.x, entry.y);
+                    float half = entry.structure ? TILE_SIZE : 3.f * zoom;
+                    sf::Color color = (entry.team == TEAM_A) ? sf::Color(255, 60, 60) : sf::Color(60, 100, 255);
+                    if (entry.structure) {
+                        color.r /= 2; color.g /= 2; color.b /= 2; // 塔用深色
+                    }
+                    m_impostors.append(sf::Vertex(sf::Vector2f(p.x - half, p.y - half), color));
+                    m_impostors.append(sf::Vertex(sf::Vector2f(p.x + half, p.y - half), color));
+                    m_impostors.append(sf::Vertex(sf::Vector2f(p.x + half, p.y + half), color));
+                    m_impostors.append(sf::Vertex(sf::Vector2f(p.x - half, p.y + half), color));
+                }
+            }
+        }
     }
 
-    // 绘制子弹
-    for (auto proj : m_projectiles) {
-        proj->render(m_window);
+    if (m_impostors.getVertexCount() > 0) {
+        m_window.draw(m_impostors);
     }
 
-    // 绘制 UI
-    renderUI();
-
-    // 绘制难度文字
-    m_window.draw(m_difficultyText);
-
-    // 绘制游戏结束文字
-    if (m_gameOver) {
-        // 绘制一个半透明背景遮罩，让文字更清晰
-        sf::RectangleShape overlay(sf::Vector2f(m_window.getSize().x, m_window.getSize().y));
-        overlay.setFillColor(sf::Color(0, 0, 0, 150));
-        m_window.draw(overlay);
-        m_window.draw(m_gameOverText);
+    // 绘制子弹
+    // 远景下子弹只有一两个像素，直接跳过
+    if (lod != LodLevel::IMPOSTOR) {
+        m_projectiles.render(m_window, visible);
     }
-
-    // 4. 显示窗口内容
-    m_window.display();
 }
 
 // 绘制 UI
 void Game::renderUI() {
+    PROFILE_SCOPE("render.ui");
     // 0. 绘制底板
     m_window.draw(m_uiBg);
 
@@ -833,9 +1013,13 @@ void Game::renderUI() {
     m_window.draw(m_elixirIcon);
 
     // 绘制圣水文字 (例如 "4 / 10")
-    std::stringstream ss;
-    ss << (int)m_elixir << " / " << (int)m_maxElixir;
-    m_elixirStatusText.setString(ss.str());
+    // 整数部分变了才重新生成字符串，其余帧直接画上次的 (每帧构造 stringstream/sf::String 都要分配)
+    if (static_cast<int>(m_elixir) != m_elixirShown) {
+        m_elixirShown = static_cast<int>(m_elixir);
+        char text[32];
+        std::snprintf(text, sizeof(text), "%d / %d", m_elixirShown, static_cast<int>(m_maxElixir));
+        m_elixirStatusText.setString(text);
+    }
     m_window.draw(m_elixirStatusText);
 
     // 2. 绘制卡牌
@@ -849,10 +1033,11 @@ void Game::renderUI() {
             // 这里我们无法直接修改 card.sprite 的颜色，因为它是 const 引用 
             // 实际上 renderUI 不应该修改状态。
             // 简单的做法是画一个半透明黑色矩形遮罩
-            sf::RectangleShape mask = card.slotShape;
-            mask.setFillColor(sf::Color(0, 0, 0, 150)); // 半透明黑
-            mask.setOutlineThickness(0);
-            m_window.draw(mask);
+            // (复用同一个遮罩，拷贝 RectangleShape 会连同顶点数组一起分配)
+            m_cardMask.setSize(card.slotShape.getSize());
+            m_cardMask.setOrigin(card.slotShape.getOrigin());
+            m_cardMask.setPosition(card.slotShape.getPosition());
+            m_window.draw(m_cardMask);
         }
     }
 }
\ No newline at end of file
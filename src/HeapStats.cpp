@@ -0,0 +1,86 @@
+#include "HeapStats.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#if defined(_WIN32)
+#include <malloc.h>
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#else
+#include <malloc.h>
+#endif
+
+namespace {
+    std::atomic<std::uint64_t> s_totalAllocations{ 0 };
+    // 平凡类型的 thread_local，不需要动态初始化，operator new 里随时可用
+    thread_local std::uint64_t t_allocations = 0;
+    thread_local std::uint64_t t_bytes = 0;
+    std::atomic<std::uint64_t> s_liveBytes{ 0 };
+    std::atomic<std::uint64_t> s_peakBytes{ 0 };
+
+    // 分配器给这块内存实际留的大小 (分配和释放两边用同一个口径，不用记请求的大小)
+    std::size_t blockSize(void* p) {
+#if defined(_WIN32)
+        return _msize(p);
+#elif defined(__APPLE__)
+        return malloc_size(p);
+#else
+        return malloc_usable_size(p);
+#endif
+    }
+}
+
+std::uint64_t HeapStats::totalAllocations() {
+    return s_totalAllocations.load(std::memory_order_relaxed);
+}
+
+std::uint64_t HeapStats::threadAllocations() {
+    return t_allocations;
+}
+
+std::uint64_t HeapStats::threadBytes() {
+    return t_bytes;
+}
+
+std::uint64_t HeapStats::liveBytes() {
+    return s_liveBytes.load(std::memory_order_relaxed);
+}
+
+std::uint64_t HeapStats::peakLiveBytes() {
+    return s_peakBytes.load(std::memory_order_relaxed);
+}
+
+void HeapStats::resetPeak() {
+    s_peakBytes.store(s_liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+// --- 全局 operator new / delete 替换 ---
+// 替换最基本的 new / delete (加上带大小的 delete)：new[]、nothrow 等其余版本的默认实现都转调它们
+// 对齐版本 (align_val_t) 保持默认，工程里没有超对齐的类型
+void* operator new(std::size_t size) {
+    s_totalAllocations.fetch_add(1, std::memory_order_relaxed);
+    t_allocations++;
+    t_bytes += size;
+    for (;;) {
+        if (void* p = std::malloc(size ? size : 1)) {
+            std::uint64_t block = blockSize(p);
+            std::uint64_t live = s_liveBytes.fetch_add(block, std::memory_order_relaxed) + block;
+            std::uint64_t peak = s_peakBytes.load(std::memory_order_relaxed);
+            while (live > peak && !s_peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+            return p;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void operator delete(void* p) noexcept {
+    if (!p) return;
+    s_liveBytes.fetch_sub(blockSize(p), std::memory_order_relaxed);
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    operator delete(p);
+}
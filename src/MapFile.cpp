@@ -0,0 +1,366 @@
+#include "MapFile.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+namespace {
+    const std::uint64_t MAP_SECTION_ALIGN = 8;
+
+    std::uint64_t alignUp(std::uint64_t value) {
+        return (value + MAP_SECTION_ALIGN - 1) & ~(MAP_SECTION_ALIGN - 1);
+    }
+
+    bool parseTeam(const std::string& token, std::uint8_t& team) {
+        if (token == "A") { team = 0; return true; }
+        if (token == "B") { team = 1; return true; }
+        return false;
+    }
+
+    char teamChar(std::uint8_t team) { return team == 0 ? 'A' : 'B'; }
+
+    // 二进制段：越界检查后返回指针
+    template <typename T>
+    const T* section(const MappedFile& file, std::uint64_t offset, std::uint64_t count) {
+        if (offset % alignof(T) != 0 || offset + count * sizeof(T) > file.size()) return nullptr;
+        return reinterpret_cast<const T*>(file.data() + offset);
+    }
+}
+
+bool MapData::inDeployZone(int team, int r, int c) const {
+    for (const auto& zone : deployZones) {
+        if (zone.team == team && zone.contains(r, c)) return true;
+    }
+    return false;
+}
+
+char MapFile::tileToChar(TileType type) {
+    switch (type) {
+        case GROUND:   return '.';
+        case RIVER:    return '~';
+        case BRIDGE:   return '=';
+        case MOUNTAIN: return '#';
+        case BASE_A:   return 'a';
+        case BASE_B:   return 'b';
+        case MUD:      return ',';
+    }
+    return '?';
+}
+
+bool MapFile::charToTile(char ch, TileType& type) {
+    switch (ch) {
+        case '.': type = GROUND;   return true;
+        case '~': type = RIVER;    return true;
+        case '=': type = BRIDGE;   return true;
+        case '#': type = MOUNTAIN; return true;
+        case 'a': type = BASE_A;   return true;
+        case 'b': type = BASE_B;   return true;
+        case ',': type = MUD;      return true;
+    }
+    return false;
+}
+
+bool MapFile::load(const std::string& fileName, MapData& out) {
+    // 只读文件头的 4 个字节判断格式
+    std::ifstream in(fileName, std::ios::binary);
+    if (!in) {
+        std::cerr << "[MapFile] Cannot open " << fileName << std::endl;
+        return false;
+    }
+    char magic[4] = {};
+    in.read(magic, 4);
+    in.close();
+
+    if (std::memcmp(magic, MAP_MAGIC, 4) == 0) return loadBinary(fileName, out);
+    return loadText(fileName, out);
+}
+
+// ======================= 文本格式 =======================
+
+bool MapFile::loadText(const std::string& fileName, MapData& out) {
+    std::ifstream in(fileName);
+    if (!in) {
+        std::cerr << "[MapFile] Cannot open " << fileName << std::endl;
+        return false;
+    }
+
+    MapData map;
+    int rows = 0, cols = 0;
+    std::vector<std::uint8_t> tiles;
+    std::string line;
+    int lineNo = 0;
+
+    auto fail = [&](const std::string& message) {
+        std::cerr << "[MapFile] " << fileName << ":" << lineNo << ": " << message << std::endl;
+        return false;
+    };
+
+    while (std::getline(in, line)) {
+        lineNo++;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        // 去掉注释 (地形行在 tiles 块里单独读取，不受 '#' 影响)
+        std::size_t hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+
+        std::istringstream ss(line);
+        std::string keyword;
+        if (!(ss >> keyword)) continue;
+
+        if (keyword == "size") {
+            if (!(ss >> rows >> cols) || rows <= 0 || cols <= 0 ||
+                rows > TileMap::MAX_DIM || cols > TileMap::MAX_DIM) {
+                return fail("bad size");
+            }
+        } else if (keyword == "tiles") {
+            if (rows <= 0) return fail("'tiles' before 'size'");
+            tiles.resize(static_cast<std::size_t>(rows) * cols);
+            // 逐行读地形字符
+            for (int r = 0; r < rows; ++r) {
+                if (!std::getline(in, line)) return fail("unexpected end of tiles");
+                lineNo++;
+                if (!line.empty() && line.back() == '\r') line.pop_back();
+                if (static_cast<int>(line.size()) != cols) return fail("tile row has wrong length");
+                for (int c = 0; c < cols; ++c) {
+                    TileType type;
+                    if (!charToTile(line[c], type)) return fail(std::string("unknown tile '") + line[c] + "'");
+                    tiles[static_cast<std::size_t>(r) * cols + c] = type;
+                }
+            }
+            if (!std::getline(in, line)) return fail("missing 'end'");
+            lineNo++;
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line != "end") return fail("expected 'end' after tiles");
+        } else if (keyword == "tower") {
+            std::string team, kind;
+            MapTower tower{};
+            if (!(ss >> team >> kind >> tower.row >> tower.col) || !parseTeam(team, tower.team) ||
+                (kind != "king" && kind != "princess")) {
+                return fail("bad tower line");
+            }
+            tower.king = (kind == "king") ? 1 : 0;
+            map.towers.push_back(tower);
+        } else if (keyword == "deploy") {
+            std::string team;
+            MapZone zone{};
+            if (!(ss >> team >> zone.row0 >> zone.col0 >> zone.row1 >> zone.col1) || !parseTeam(team, zone.team)) {
+                return fail("bad deploy line");
+            }
+            map.deployZones.push_back(zone);
+        } else if (keyword == "lane") {
+            std::string team;
+            MapLane lane{};
+            if (!(ss >> team >> lane.entryRow >> lane.entryCol >> lane.targetRow >> lane.targetCol) ||
+                !parseTeam(team, lane.team)) {
+                return fail("bad lane line");
+            }
+            map.lanes.push_back(lane);
+        } else {
+            return fail("unknown keyword '" + keyword + "'");
+        }
+    }
+
+    if (tiles.empty()) {
+        std::cerr << "[MapFile] " << fileName << ": no tiles" << std::endl;
+        return false;
+    }
+    if (!map.tiles.assign(rows, cols, tiles.data())) return false;
+    if (!validate(map, fileName)) return false;
+
+    out = std::move(map);
+    std::cout << "[MapFile] Loaded " << fileName << " (" << rows << "x" << cols << ")" << std::endl;
+    return true;
+}
+
+bool MapFile::saveText(const std::string& fileName, const MapData& map) {
+    std::ofstream out(fileName);
+    if (!out) return false;
+
+    const TileMap& tiles = map.tiles;
+    out << "# BattleSim map\n";
+    out << "size " << tiles.rows() << " " << tiles.cols() << "\n";
+    out << "tiles\n";
+    std::string row(tiles.cols(), '.');
+    for (int r = 0; r < tiles.rows(); ++r) {
+        for (int c = 0; c < tiles.cols(); ++c) row[c] = tileToChar(tiles.at(r, c));
+        out << row << "\n";
+    }
+    out << "end\n";
+    for (const auto& t : map.towers) {
+        out << "tower " << teamChar(t.team) << " " << (t.king ? "king" : "princess")
+            << " " << t.row << " " << t.col << "\n";
+    }
+    for (const auto& z : map.deployZones) {
+        out << "deploy " << teamChar(z.team) << " " << z.row0 << " " << z.col0
+            << " " << z.row1 << " " << z.col1 << "\n";
+    }
+    for (const auto& l : map.lanes) {
+        out << "lane " << teamChar(l.team) << " " << l.entryRow << " " << l.entryCol
+            << " " << l.targetRow << " " << l.targetCol << "\n";
+    }
+    return out.good();
+}
+
+// ======================= 二进制格式 =======================
+
+bool MapFile::loadBinary(const std::string& fileName, MapData& out) {
+    MappedFile file;
+    if (!file.open(fileName)) {
+        std::cerr << "[MapFile] Cannot map " << fileName << std::endl;
+        return false;
+    }
+
+    const MapFileHeader* header = section<MapFileHeader>(file, 0, 1);
+    if (!header || std::memcmp(header->magic, MAP_MAGIC, 4) != 0 || header->version != MAP_VERSION) {
+        std::cerr << "[MapFile] Bad header in " << fileName << std::endl;
+        return false;
+    }
+
+    std::uint64_t tileCount = static_cast<std::uint64_t>(header->rows) * header->cols;
+    const std::uint8_t* tiles = section<std::uint8_t>(file, header->tilesOffset, tileCount);
+    const MapTower* towers = section<MapTower>(file, header->towersOffset, header->towerCount);
+    const MapZone* zones = section<MapZone>(file, header->zonesOffset, header->zoneCount);
+    const MapLane* lanes = section<MapLane>(file, header->lanesOffset, header->laneCount);
+    if (!tiles || !towers || !zones || !lanes) {
+        std::cerr << "[MapFile] Truncated map: " << fileName << std::endl;
+        return false;
+    }
+
+    MapData map;
+    if (!map.tiles.assign(static_cast<int>(header->rows), static_cast<int>(header->cols), tiles)) return false;
+    map.towers.assign(towers, towers + header->towerCount);
+    map.deployZones.assign(zones, zones + header->zoneCount);
+    map.lanes.assign(lanes, lanes + header->laneCount);
+    if (!validate(map, fileName)) return false;
+
+    out = std::move(map);
+    std::cout << "[MapFile] Mapped " << fileName << " (" << header->rows << "x" << header->cols << ")" << std::endl;
+    return true;
+}
+
+bool MapFile::saveBinary(const std::string& fileName, const MapData& map) {
+    const TileMap& tiles = map.tiles;
+
+    MapFileHeader header{};
+    std::memcpy(header.magic, MAP_MAGIC, 4);
+    header.version = MAP_VERSION;
+    header.rows = tiles.rows();
+    header.cols = tiles.cols();
+    header.towerCount = static_cast<std::uint32_t>(map.towers.size());
+    header.zoneCount = static_cast<std::uint32_t>(map.deployZones.size());
+    header.laneCount = static_cast<std::uint32_t>(map.lanes.size());
+
+    header.tilesOffset = alignUp(sizeof(MapFileHeader));
+    header.towersOffset = alignUp(header.tilesOffset + static_cast<std::uint64_t>(tiles.size()));
+    header.zonesOffset = alignUp(header.towersOffset + map.towers.size() * sizeof(MapTower));
+    header.lanesOffset = alignUp(header.zonesOffset + map.deployZones.size() * sizeof(MapZone));
+    std::uint64_t totalSize = header.lanesOffset + map.lanes.size() * sizeof(MapLane);
+
+    // 先在内存里拼好，再一次写出
+    std::vector<std::uint8_t> bytes(totalSize, 0);
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    std::memcpy(bytes.data() + header.tilesOffset, tiles.data(), tiles.size());
+    if (!map.towers.empty())
+        std::memcpy(bytes.data() + header.towersOffset, map.towers.data(), map.towers.size() * sizeof(MapTower));
+    if (!map.deployZones.empty())
+        std::memcpy(bytes.data() + header.zonesOffset, map.deployZones.data(), map.deployZones.size() * sizeof(MapZone));
+    if (!map.lanes.empty())
+        std::memcpy(bytes.data() + header.lanesOffset, map.lanes.data(), map.lanes.size() * sizeof(MapLane));
+
+    std::ofstream out(fileName, std::ios::binary);
+    if (!out) return false;
+    out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return out.good();
+}
+
+// ======================= 程序化生成 =======================
+
+bool MapFile::generate(int rows, int cols, MapData& out, float obstacleDensity, unsigned seed) {
+    // 至少要放得下：上下各三座塔 + 中间的河
+    if (rows < 11 || cols < 7) {
+        std::cerr << "[MapFile] Map too small to generate: " << rows << "x" << cols << std::endl;
+        return false;
+    }
+
+    MapData map;
+    if (!map.tiles.create(rows, cols, GROUND)) return false;
+    TileMap& tiles = map.tiles;
+
+    // 1. 塔：国王塔在中线，公主塔在左右三分之一处 (上下镜像)
+    int riverRow = rows / 2;
+    int kingCol = cols / 2;
+    int leftCol = cols / 3;
+    int rightCol = cols - 1 - cols / 3;
+    int kingRowA = 2, princessRowA = 4;
+    int kingRowB = rows - 3, princessRowB = rows - 5;
+
+    map.towers = {
+        { kingRowA, kingCol, 0, 1, {} }, { princessRowA, leftCol, 0, 0, {} }, { princessRowA, rightCol, 0, 0, {} },
+        { kingRowB, kingCol, 1, 1, {} }, { princessRowB, leftCol, 1, 0, {} }, { princessRowB, rightCol, 1, 0, {} },
+    };
+
+    // 2. 随机山脉 (避开河道附近，保证桥头可达)
+    if (obstacleDensity > 0.f) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> dist(0.f, 1.f);
+        for (int r = 0; r < rows; ++r) {
+            if (std::abs(r - riverRow) <= 1) continue;
+            for (int c = 0; c < cols; ++c) {
+                if (dist(rng) < obstacleDensity) tiles.set(r, c, MOUNTAIN);
+            }
+        }
+    }
+
+    // 3. 河流与桥 (桥宽随地图变宽)
+    int bridgeWidth = std::max(1, cols / 64);
+    for (int c = 0; c < cols; ++c) tiles.set(riverRow, c, RIVER);
+    for (int w = 0; w < bridgeWidth; ++w) {
+        tiles.set(riverRow, std::min(cols - 1, leftCol + w), BRIDGE);
+        tiles.set(riverRow, std::max(0, rightCol - w), BRIDGE);
+    }
+
+    // 4. 塔所在格标记为基地 (覆盖随机山脉)
+    for (const auto& t : map.towers) {
+        tiles.set(t.row, t.col, t.team == 0 ? BASE_A : BASE_B);
+    }
+
+    // 5. 部署区：各自半场；进攻路线：过己方桥头，打对面的公主塔
+    map.deployZones = {
+        { 0, 0, riverRow - 1, cols - 1, 0, {} },
+        { riverRow + 1, 0, rows - 1, cols - 1, 1, {} },
+    };
+    map.lanes = {
+        { riverRow - 1, leftCol, princessRowB, leftCol, 0, {} },
+        { riverRow - 1, rightCol, princessRowB, rightCol, 0, {} },
+        { riverRow + 1, leftCol, princessRowA, leftCol, 1, {} },
+        { riverRow + 1, rightCol, princessRowA, rightCol, 1, {} },
+    };
+
+    out = std::move(map);
+    return true;
+}
+
+bool MapFile::validate(const MapData& map, const std::string& fileName) {
+    const TileMap& tiles = map.tiles;
+    for (const auto& t : map.towers) {
+        if (!tiles.inBounds(t.row, t.col) || t.team > 1) {
+            std::cerr << "[MapFile] " << fileName << ": tower out of bounds" << std::endl;
+            return false;
+        }
+    }
+    for (const auto& z : map.deployZones) {
+        if (!tiles.inBounds(z.row0, z.col0) || !tiles.inBounds(z.row1, z.col1) || z.team > 1) {
+            std::cerr << "[MapFile] " << fileName << ": deploy zone out of bounds" << std::endl;
+            return false;
+        }
+    }
+    for (const auto& l : map.lanes) {
+        if (!tiles.inBounds(l.entryRow, l.entryCol) || !tiles.inBounds(l.targetRow, l.targetCol) || l.team > 1) {
+            std::cerr << "[MapFile] " << fileName << ": lane out of bounds" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
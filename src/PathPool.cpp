@@ -0,0 +1,90 @@
+#include "PathPool.h"
+
+PathPool& PathPool::getInstance() {
+    static PathPool instance;
+    return instance;
+}
+
+std::int32_t PathPool::allocate() {
+    std::int32_t index;
+    if (m_freeHead >= 0) {
+        index = m_freeHead;
+        m_freeHead = m_chunks[index].next;
+    } else {
+        index = static_cast<std::int32_t>(m_chunks.size());
+        m_chunks.emplace_back();
+    }
+    m_chunks[index].next = -1;
+    m_inUse++;
+    return index;
+}
+
+void PathPool::release(std::int32_t index) {
+    m_chunks[index].next = m_freeHead;
+    m_freeHead = index;
+    m_inUse--;
+}
+
+// ======================= WaypointQueue =======================
+
+void WaypointQueue::push_back(const sf::Vector2f& point) {
+    // 溢出段非空时必须继续往溢出段写，保证顺序
+    if (m_spillCount == 0 && m_count < INLINE_CAPACITY) {
+        m_ring[(m_head + m_count) % INLINE_CAPACITY] = point;
+        m_count++;
+        return;
+    }
+
+    PathPool& pool = PathPool::getInstance();
+    if (m_spillTail < 0) {
+        m_spillHead = m_spillTail = pool.allocate();
+        m_spillRead = m_spillWrite = 0;
+    } else if (m_spillWrite == PathPool::CHUNK_SIZE) {
+        std::int32_t next = pool.allocate();
+        pool.chunk(m_spillTail).next = next;
+        m_spillTail = next;
+        m_spillWrite = 0;
+    }
+    pool.chunk(m_spillTail).points[m_spillWrite++] = point;
+    m_spillCount++;
+}
+
+void WaypointQueue::pop_front() {
+    if (m_count == 0) return;
+    m_head = (m_head + 1) % INLINE_CAPACITY;
+    m_count--;
+    if (m_spillCount == 0) return;
+
+    // 从溢出段补一个点到环尾
+    PathPool& pool = PathPool::getInstance();
+    m_ring[(m_head + m_count) % INLINE_CAPACITY] = pool.chunk(m_spillHead).points[m_spillRead++];
+    m_count++;
+    m_spillCount--;
+
+    if (m_spillCount == 0) {
+        // 溢出段读完：归还最后一块 (此时头尾是同一块)
+        pool.release(m_spillHead);
+        m_spillHead = m_spillTail = -1;
+    } else if (m_spillRead == PathPool::CHUNK_SIZE) {
+        std::int32_t next = pool.chunk(m_spillHead).next;
+        pool.release(m_spillHead);
+        m_spillHead = next;
+        m_spillRead = 0;
+    }
+}
+
+void WaypointQueue::clear() {
+    if (m_spillHead >= 0) {
+        PathPool& pool = PathPool::getInstance();
+        for (std::int32_t i = m_spillHead; i >= 0;) {
+            std::int32_t next = pool.chunk(i).next;
+            pool.release(i);
+            i = next;
+        }
+    }
+    m_head = 0;
+    m_count = 0;
+    m_spillHead = m_spillTail = -1;
+    m_spillRead = m_spillWrite = 0;
+    m_spillCount = 0;
+}
@@ -0,0 +1,103 @@
+#include "PathScheduler.h"
+#include "Unit.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+namespace {
+    // 每次推进搜索的展开数，推进之间检查一次时钟
+    const int SLICE_EXPANSIONS = 256;
+}
+
+void PathScheduler::request(Unit* unit, sf::Vector2i start, sf::Vector2i goal, PathUrgency urgency) {
+    auto it = m_pending.find(unit);
+    if (it == m_pending.end()) {
+        std::uint32_t serial = m_nextSerial++;
+        m_pending.emplace(unit, Request{ start, goal, serial, urgency });
+        m_queue.push(QueueEntry{ urgency, serial, unit });
+        return;
+    }
+
+    // 已有请求：就地更新，序号不变，排队位置也就不变
+    Request& req = it->second;
+    if (unit == m_activeUnit) {
+        int moved = std::max(std::abs(goal.x - req.goal.x), std::abs(goal.y - req.goal.y));
+        // 目标只挪了一点：让搜了一半的结果照常送回
+        if (moved <= GOAL_SLACK_CELLS) return;
+
+        // 目标跑远了才作废当前搜索，用原序号重新入队 (比它之后提交的同级请求都靠前)
+        m_activeUnit = nullptr;
+        req.start = start;
+        req.goal = goal;
+        req.urgency = std::max(req.urgency, urgency);
+        m_queue.push(QueueEntry{ req.urgency, req.serial, unit });
+        return;
+    }
+
+    // 还在排队：改起终点即可，紧急程度升高时补一个更靠前的队列项
+    req.start = start;
+    req.goal = goal;
+    if (urgency > req.urgency) {
+        req.urgency = urgency;
+        m_queue.push(QueueEntry{ urgency, req.serial, unit });
+    }
+}
+
+void PathScheduler::cancel(Unit* unit) {
+    m_pending.erase(unit);
+    if (unit == m_activeUnit) m_activeUnit = nullptr;
+}
+
+bool PathScheduler::startNext(const TileMap& map) {
+    while (!m_queue.empty()) {
+        QueueEntry entry = m_queue.top();
+        m_queue.pop();
+
+        auto it = m_pending.find(entry.unit);
+        if (it == m_pending.end() || it->second.serial != entry.serial) continue; // 已完成或撤销
+
+        m_search.begin(map, it->second.start, it->second.goal);
+        m_activeUnit = entry.unit;
+        m_activeSerial = entry.serial;
+        return true;
+    }
+    return false;
+}
+
+void PathScheduler::finishActive(const TileMap& map) {
+    Unit* unit = m_activeUnit;
+    m_activeUnit = nullptr;
+
+    auto it = m_pending.find(unit);
+    if (it == m_pending.end() || it->second.serial != m_activeSerial) return;
+    sf::Vector2i start = it->second.start;
+    m_pending.erase(it);
+
+    bool found = m_search.status() == PathSearch::Status::FOUND;
+    m_result.clear();
+    if (found) {
+        m_result = m_search.path();
+        Pathfinder::smoothPath(map, start, m_result);
+    }
+    unit->onPathReady(m_result, found);
+}
+
+void PathScheduler::update(const TileMap& map) {
+    auto t0 = std::chrono::steady_clock::now();
+    int expansions = 0;
+    float elapsed = 0.f;
+
+    while (expansions < m_budget.maxExpansions && elapsed < m_budget.maxMillis) {
+        if (!m_activeUnit && !startNext(map)) break;
+
+        int before = m_search.expansions();
+        PathSearch::Status status = m_search.step(std::min(SLICE_EXPANSIONS, m_budget.maxExpansions - expansions));
+        expansions += m_search.expansions() - before;
+        if (status != PathSearch::Status::RUNNING) finishActive(map);
+
+        elapsed = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    m_lastExpansions = expansions;
+    m_lastMillis = elapsed;
+}
@@ -1,143 +1,580 @@
 #include "Pathfinder.h"
+#include "SearchBuffers.h"
+#include "FrameArena.h"
+#include "Profiler.h"
 #include <queue>
-#include <map>
 #include <algorithm>
 #include <iostream>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
-// 比较器，用于让 sf::Vector2i 可以作为 std::map 的 key
-struct Vector2iComparator {
-    bool operator()(const sf::Vector2i& a, const sf::Vector2i& b) const {
-        if (a.x != b.x) return a.x < b.x;
-        return a.y < b.y;
-    }
-};
+// 64 位字最低的置位位置 (调用方保证 x != 0)
+static int ctz64(std::uint64_t x) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(x);
+#endif
+}
 
-// 优先队列的节点结构
-struct Node {
-    sf::Vector2i pos; // 坐标
-    int priority;     // F 值 (G + H)
+namespace {
+    // 逻辑线程和压测线程各用各的缓冲 (A* 和 JPS 共用)
+    SearchScratch& threadScratch(std::size_t cells) {
+        thread_local SearchScratch scratch;
+        scratch.prepare(cells);
+        return scratch;
+    }
 
-    // 优先队列默认是大顶堆，我们需要小顶堆（F值越小越优先）
-    // 所以这里的 > 实际上是让 F 值小的排在前面
-    bool operator>(const Node& other) const {
-        return priority > other.priority;
+    BucketQueue& threadQueue() {
+        thread_local BucketQueue queue;
+        queue.clear();
+        return queue;
     }
-};
+}
 
 // 启发函数：曼哈顿距离 (Manhattan Distance)
-// 适用于只能上下左右移动的网格地图
+// 适用于只能上下左右移动的网格地图；最便宜的地形代价是 1，所以加权后仍然可采纳
 int heuristic(sf::Vector2i a, sf::Vector2i b) {
     return std::abs(a.x - b.x) + std::abs(a.y - b.y);
 }
 
-bool Pathfinder::isValid(const std::vector<std::vector<int>>& mapData, int r, int c) {
-    int rows = mapData.size();
-    int cols = mapData[0].size();
-    
-    // 1. 越界检查
-    if (r < 0 || r >= rows || c < 0 || c >= cols) return false;
-
-    // 2. 障碍物检查
-    int type = mapData[r][c];
-    // 河流(RIVER) 和 山脉(MOUNTAIN) 不可走
-    // 地面(GROUND)、桥(BRIDGE)、基地(BASE) 可走
-    if (type == RIVER || type == MOUNTAIN) return false;
-
-    return true;
-}
-
 std::vector<sf::Vector2i> Pathfinder::findPath(
-    const std::vector<std::vector<int>>& mapData, 
+    const TileMap& map, 
     sf::Vector2i start, 
-    sf::Vector2i end
+    sf::Vector2i end,
+    PathMode mode
 ) {
+    PROFILE_SCOPE("findPath");
     std::vector<sf::Vector2i> path;
     
     // 如果起点或终点本身无效，直接返回空
-    if (!isValid(mapData, start.y, start.x) || !isValid(mapData, end.y, end.x)) {
+    // 起点终点来自外部，可能在地图外，这里要做越界判断
+    if (!map.isPassable(start.y, start.x) || !map.isPassable(end.y, end.x)) {
         std::cout << "[Pathfinder] Start or End is invalid!" << std::endl;
         return path;
     }
 
-    // 1. 优先队列 (Open Set)
-    // 存储待遍历的节点，F 值最小的在队首
-    std::priority_queue<Node, std::vector<Node>, std::greater<Node>> openSet;
-    openSet.push({start, 0});
+    if (mode == PathMode::JPS) {
+        return findPathJPS(map, start, end);
+    }
+    // 同步查询就是一次不限展开数的分段搜索
+    thread_local PathSearch search;
+    search.begin(map, start, end);
+    if (search.step(map.size()) == PathSearch::Status::FOUND) {
+        path = search.path();
+    }
+    return path;
+}
+
+// ======================= 分段 A* =======================
+
+void PathSearch::begin(const TileMap& map, sf::Vector2i start, sf::Vector2i end) {
+    m_map = &map;
+    m_start = start;
+    m_end = end;
+    m_path.clear();
+    m_open.clear();
+    m_expansions = 0;
 
-    // 2. 记录路径来源 (Came From)
-    // key: 当前点, value: 上一个点 (用于回溯路径)
-    std::map<sf::Vector2i, sf::Vector2i, Vector2iComparator> cameFrom;
+    if (!map.isPassable(start.y, start.x) || !map.isPassable(end.y, end.x)) {
+        m_status = Status::FAILED;
+        return;
+    }
+    if (start == end) {
+        m_status = Status::FOUND;
+        return;
+    }
 
-     // 3. 记录当前花费 (Cost So Far / G Cost)
-    // key: 坐标, value: 从起点到该点的实际代价
-    std::map<sf::Vector2i, int, Vector2iComparator> costSoFar;
+    // 每格状态 (G 值 / 父节点 / 是否已关闭) 放在按地图大小复用的数组里
+    m_scratch.prepare(static_cast<std::size_t>(map.size()));
+    std::int32_t startIndex = start.y * map.cols() + start.x;
+    m_scratch.stamp[startIndex] = m_scratch.generation;
+    m_scratch.g[startIndex] = 0;
+    m_scratch.parent[startIndex] = -1;
+    m_scratch.closed[startIndex] = 0;
+    // 开放列表：F 值是小整数，用桶队列代替 std::priority_queue
+    m_open.push(heuristic(start, end), startIndex);
+    m_status = Status::RUNNING;
+}
 
-    // 初始化
-    cameFrom[start] = start;
-    costSoFar[start] = 0;
+PathSearch::Status PathSearch::step(int maxExpansions) {
+    if (m_status != Status::RUNNING) return m_status;
 
-    bool found = false;
+    const TileMap& map = *m_map;
+    const int cols = map.cols();
+    const std::uint32_t gen = m_scratch.generation;
+    const std::int32_t endIndex = m_end.y * cols + m_end.x;
 
     // 上下左右四个方向 (row, col)
-    int dr[] = {-1, 1, 0, 0};
-    int dc[] = {0, 0, -1, 1};
+    const int dr[] = {-1, 1, 0, 0};
+    const int dc[] = {0, 0, -1, 1};
+
+    for (int budget = maxExpansions; budget > 0; ) {
+        if (m_open.empty()) {
+            m_status = Status::FAILED;
+            return m_status;
+        }
 
-    while (!openSet.empty()) {
         // 取出 F 值最小的节点
-        sf::Vector2i current = openSet.top().pos;
-        openSet.pop();
+        std::uint32_t f;
+        std::int32_t currentIndex = m_open.pop(f);
+        if (m_scratch.closed[currentIndex]) continue; // 过期的队列项，不计入预算
+        m_scratch.closed[currentIndex] = 1;
+        m_expansions++;
+        budget--;
 
-        // 找到终点？提前结束
-        if (current == end) {
-            found = true;
-            break;
+        // 找到终点？回溯路径
+        if (currentIndex == endIndex) {
+            std::int32_t startIndex = m_start.y * cols + m_start.x;
+            for (std::int32_t i = endIndex; i != startIndex; i = m_scratch.parent[i]) {
+                m_path.push_back(sf::Vector2i(i % cols, i / cols));
+            }
+            // 反转，变成 起点(不含) -> ... -> 终点
+            std::reverse(m_path.begin(), m_path.end());
+            m_status = Status::FOUND;
+            return m_status;
         }
 
+        int r = currentIndex / cols;
+        int c = currentIndex % cols;
+
         // 遍历邻居
         for (int i = 0; i < 4; i++) {
-            int nextR = current.y + dr[i];
-            int nextC = current.x + dc[i];
-            sf::Vector2i next(nextC, nextR);
+            int nextR = r + dr[i];
+            int nextC = c + dc[i];
+
+            // 位图带哨兵边框：界内格子的邻居即使在地图外也能直接查，不需要越界判断
+            // 河流(RIVER) 和 山脉(MOUNTAIN) 不可走，其余地形的代价见 TILE_INFO
+            if (!map.isPassableUnchecked(nextR, nextC)) continue;
+
+            std::int32_t nextIndex = nextR * cols + nextC;
+            bool seen = m_scratch.stamp[nextIndex] == gen;
+            if (seen && m_scratch.closed[nextIndex]) continue; // 启发一致，关闭的格子不会再变短
+
+            // 新的 G 值 = 当前 G + 进入邻居格的地形代价
+            int newCost = m_scratch.g[currentIndex] + map.stepCost(nextR, nextC);
+            if (!seen || newCost < m_scratch.g[nextIndex]) {
+                m_scratch.stamp[nextIndex] = gen;
+                m_scratch.g[nextIndex] = newCost;
+                m_scratch.parent[nextIndex] = currentIndex;
+                m_scratch.closed[nextIndex] = 0;
+                // F 值 = G + H
+                m_open.push(newCost + heuristic(sf::Vector2i(nextC, nextR), m_end), nextIndex);
+            }
+        }
+    }
+    return m_status;
+}
+
+// ======================= 跳点搜索 (JPS) =======================
+
+namespace {
+    // 直线代价 10，斜线代价 14 (≈ 10 * √2)，全用整数；进入加权格时再乘上该格的代价
+    const int COST_STRAIGHT = 10;
+    const int COST_DIAGONAL = 14;
+
+    // 八方向距离 (Octile)：允许斜走时的可采纳启发
+    int octile(sf::Vector2i a, sf::Vector2i b) {
+        int dx = std::abs(a.x - b.x);
+        int dy = std::abs(a.y - b.y);
+        return COST_STRAIGHT * (dx + dy) + (COST_DIAGONAL - 2 * COST_STRAIGHT) * std::min(dx, dy);
+    }
+
+    int sign(int v) { return (v > 0) - (v < 0); }
+
+    struct JpsNode {
+        int f;
+        std::int32_t index;
+        bool operator>(const JpsNode& other) const { return f > other.f; }
+    };
+
+    // 加权格的处理：跳跃只穿过周围 3x3 全是平价格的格子
+    // 加权格本身和紧挨着它的格子都当作跳点停下，在那里不剪枝、八个方向都展开 (相当于普通 A*)，
+    // 所以一次跳跃经过的格子全是代价 1，只有落脚的最后一格可能是加权格
+    // 地图上只有几座桥、几片泥地时，绝大部分跳跃和没有加权格时一样长
+    class JumpSearch {
+    public:
+        JumpSearch(const TileMap& map, sf::Vector2i end)
+            : m_map(map), m_end(end), m_weighted(!map.isUniformCost()) {}
+
+        bool open(int x, int y) const { return m_map.isPassableUnchecked(y, x); }
+
+        // 附近有加权格，必须停下来按实际代价展开
+        bool nearWeighted(int x, int y) const { return m_weighted && m_map.hasWeightedAround(y, x); }
+
+        // 沿直线跳跃，遇到终点或强制邻居时停下
+        bool jumpStraight(int x, int y, int dx, int dy, sf::Vector2i& out) const {
+            while (true) {
+                if (!open(x, y)) return false;
+                if ((x == m_end.x && y == m_end.y) || nearWeighted(x, y)) break;
+                if (dx != 0) {
+                    // 横向走：上/下方刚从墙后露出来 -> 这里是跳点
+                    if ((open(x, y - 1) && !open(x - dx, y - 1)) ||
+                        (open(x, y + 1) && !open(x - dx, y + 1))) break;
+                } else {
+                    if ((open(x - 1, y) && !open(x - 1, y - dy)) ||
+                        (open(x + 1, y) && !open(x + 1, y - dy))) break;
+                }
+                x += dx;
+                y += dy;
+            }
+            out = sf::Vector2i(x, y);
+            return true;
+        }
+
+        // 任意方向跳跃 (斜向时，每一步先沿两个分量方向直跳探路)
+        bool jump(int x, int y, int dx, int dy, sf::Vector2i& out) const {
+            if (dx == 0 || dy == 0) return jumpStraight(x, y, dx, dy, out);
+            sf::Vector2i probe;
+            while (true) {
+                if (!open(x, y)) return false;
+                if ((x == m_end.x && y == m_end.y) || nearWeighted(x, y) ||
+                    jumpStraight(x + dx, y, dx, 0, probe) ||
+                    jumpStraight(x, y + dy, 0, dy, probe)) {
+                    out = sf::Vector2i(x, y);
+                    return true;
+                }
+                // 不切角：两侧直邻格都通才能继续斜走
+                if (!open(x + dx, y) || !open(x, y + dy)) return false;
+                x += dx;
+                y += dy;
+            }
+        }
 
-            // 如果邻居是障碍物，跳过
-            if (!isValid(mapData, nextR, nextC)) {
-                continue;
+        // 按来向剪枝后的邻居方向
+        int neighbours(sf::Vector2i node, sf::Vector2i parent, bool hasParent, sf::Vector2i dirs[8]) const {
+            int n = 0;
+            int x = node.x, y = node.y;
+            if (!hasParent || nearWeighted(x, y)) {
+                for (int dy = -1; dy <= 1; ++dy) {
+                    for (int dx = -1; dx <= 1; ++dx) {
+                        if (dx == 0 && dy == 0) continue;
+                        if (!open(x + dx, y + dy)) continue;
+                        if (dx != 0 && dy != 0 && (!open(x + dx, y) || !open(x, y + dy))) continue;
+                        dirs[n++] = sf::Vector2i(dx, dy);
+                    }
+                }
+                return n;
             }
 
-            // 计算新的 G 值 (假设每格代价为 1)
-            int newCost = costSoFar[current] + 1;
-
-            // 如果该邻居没访问过，或者发现了更短的路径到达该邻居
-            if (costSoFar.find(next) == costSoFar.end() || newCost < costSoFar[next]) {
-                
-                // 更新 G 值
-                costSoFar[next] = newCost;
-                
-                // 计算 F 值 = G + H
-                int priority = newCost + heuristic(next, end);
-                
-                // 加入优先队列
-                openSet.push({next, priority});
-                
-                // 记录父节点
-                cameFrom[next] = current;
+            int dx = sign(x - parent.x);
+            int dy = sign(y - parent.y);
+            if (dx != 0 && dy != 0) {
+                bool horizontal = open(x + dx, y);
+                bool vertical = open(x, y + dy);
+                if (vertical) dirs[n++] = sf::Vector2i(0, dy);
+                if (horizontal) dirs[n++] = sf::Vector2i(dx, 0);
+                if (horizontal && vertical) dirs[n++] = sf::Vector2i(dx, dy);
+            } else if (dx != 0) {
+                bool next = open(x + dx, y);
+                bool up = open(x, y - 1);
+                bool down = open(x, y + 1);
+                if (next) {
+                    dirs[n++] = sf::Vector2i(dx, 0);
+                    if (up) dirs[n++] = sf::Vector2i(dx, -1);
+                    if (down) dirs[n++] = sf::Vector2i(dx, 1);
+                }
+                if (up) dirs[n++] = sf::Vector2i(0, -1);
+                if (down) dirs[n++] = sf::Vector2i(0, 1);
+            } else {
+                bool next = open(x, y + dy);
+                bool left = open(x - 1, y);
+                bool right = open(x + 1, y);
+                if (next) {
+                    dirs[n++] = sf::Vector2i(0, dy);
+                    if (left) dirs[n++] = sf::Vector2i(-1, dy);
+                    if (right) dirs[n++] = sf::Vector2i(1, dy);
+                }
+                if (left) dirs[n++] = sf::Vector2i(-1, 0);
+                if (right) dirs[n++] = sf::Vector2i(1, 0);
             }
+            return n;
         }
+
+    private:
+        const TileMap& m_map;
+        sf::Vector2i m_end;
+        bool m_weighted; // 地图上有加权格 (没有时连检查都省掉)
+    };
+}
+
+std::vector<sf::Vector2i> Pathfinder::findPathJPS(const TileMap& map, sf::Vector2i start, sf::Vector2i end) {
+    std::vector<sf::Vector2i> path;
+    if (start == end) return path;
+
+    const int cols = map.cols();
+    auto indexOf = [cols](sf::Vector2i p) { return p.y * cols + p.x; };
+    auto posOf = [cols](std::int32_t i) { return sf::Vector2i(i % cols, i / cols); };
+
+    SearchScratch& scratch = threadScratch(static_cast<std::size_t>(map.size()));
+    const std::uint32_t gen = scratch.generation;
+
+    JumpSearch search(map, end);
+    // 开放列表是这次查询的临时数据，放在逐帧分配器上，返回时退回
+    FrameArena& arena = FrameArena::forThread();
+    FrameArena::Scope arenaScope(arena);
+    std::priority_queue<JpsNode, std::pmr::vector<JpsNode>, std::greater<JpsNode>> openSet{
+        std::greater<JpsNode>(), std::pmr::vector<JpsNode>(&arena) };
+
+    std::int32_t startIndex = indexOf(start);
+    scratch.stamp[startIndex] = gen;
+    scratch.g[startIndex] = 0;
+    scratch.parent[startIndex] = -1;
+    scratch.closed[startIndex] = 0;
+    openSet.push({octile(start, end), startIndex});
+
+    std::int32_t endIndex = indexOf(end);
+    bool found = false;
+    sf::Vector2i dirs[8];
+
+    while (!openSet.empty()) {
+        std::int32_t currentIndex = openSet.top().index;
+        openSet.pop();
+        if (scratch.closed[currentIndex]) continue; // 过期的队列项
+        scratch.closed[currentIndex] = 1;
+
+        if (currentIndex == endIndex) {
+            found = true;
+            break;
+        }
+
+        sf::Vector2i current = posOf(currentIndex);
+        std::int32_t parentIndex = scratch.parent[currentIndex];
+        int dirCount = search.neighbours(current, parentIndex >= 0 ? posOf(parentIndex) : current, parentIndex >= 0, dirs);
+
+        for (int i = 0; i < dirCount; ++i) {
+            sf::Vector2i jumpPoint;
+            if (!search.jump(current.x + dirs[i].x, current.y + dirs[i].y, dirs[i].x, dirs[i].y, jumpPoint)) continue;
+
+            std::int32_t jumpIndex = indexOf(jumpPoint);
+            bool seen = scratch.stamp[jumpIndex] == gen;
+            if (seen && scratch.closed[jumpIndex]) continue;
+
+            // 跳跃途经的格子都是平价格，落脚格是加权格时最后一步按它的代价加价
+            int newCost = scratch.g[currentIndex] + octile(current, jumpPoint) +
+                (map.stepCost(jumpPoint.y, jumpPoint.x) - 1) * (dirs[i].x != 0 && dirs[i].y != 0 ? COST_DIAGONAL : COST_STRAIGHT);
+            if (!seen || newCost < scratch.g[jumpIndex]) {
+                scratch.stamp[jumpIndex] = gen;
+                scratch.g[jumpIndex] = newCost;
+                scratch.parent[jumpIndex] = currentIndex;
+                scratch.closed[jumpIndex] = 0;
+                openSet.push({newCost + octile(jumpPoint, end), jumpIndex});
+            }
+        }
+    }
+
+    if (!found) return path;
+
+    // 回溯跳点，只保留方向发生变化的拐点 (终点总是保留)
+    for (std::int32_t i = endIndex; i != startIndex; i = scratch.parent[i]) {
+        path.push_back(posOf(i));
     }
+    path.push_back(start);
+    std::reverse(path.begin(), path.end());
 
-    // 路径重构 (回溯)
-    if (found) {
-        sf::Vector2i curr = end;
-        while (curr != start) {
-            path.push_back(curr);
-            curr = cameFrom[curr];
+    std::vector<sf::Vector2i> corners;
+    for (std::size_t i = 1; i < path.size(); ++i) {
+        if (i + 1 < path.size()) {
+            sf::Vector2i in(sign(path[i].x - path[i - 1].x), sign(path[i].y - path[i - 1].y));
+            sf::Vector2i out(sign(path[i + 1].x - path[i].x), sign(path[i + 1].y - path[i].y));
+            if (in == out) continue; // 共线的中间跳点
         }
-        // path 目前是 终点 -> 起点
-        // 反转，变成 起点(不含) -> ... -> 终点
-        std::reverse(path.begin(), path.end());
-    } else {
-        // std::cout << "[Pathfinder] 未找到路径!" << std::endl;
+        corners.push_back(path[i]);
     }
+    return corners;
+}
 
-    return path;
-}
\ No newline at end of file
+// ======================= 路径平滑 =======================
+
+bool Pathfinder::lineOfSight(const TileMap& map, sf::Vector2i from, sf::Vector2i to, int maxCost) {
+    // 沿连线逐格走 (经过的每一格都检查，不漏格)
+    // error 记录连线相对当前格的偏向：> 0 先横走，< 0 先竖走，== 0 恰好穿过格角
+    auto open = [&](int x, int y) { return map.isPassableUnchecked(y, x) && map.stepCost(y, x) <= maxCost; };
+
+    int dx = std::abs(to.x - from.x);
+    int dy = std::abs(to.y - from.y);
+    int stepX = to.x > from.x ? 1 : -1;
+    int stepY = to.y > from.y ? 1 : -1;
+    int error = dx - dy;
+    int x = from.x, y = from.y;
+
+    while (true) {
+        if (!open(x, y)) return false;
+        if (x == to.x && y == to.y) return true;
+        if (error > 0) {
+            x += stepX;
+            error -= 2 * dy;
+        } else if (error < 0) {
+            y += stepY;
+            error += 2 * dx;
+        } else {
+            // 穿过格角：不切角，两侧的格子都要通
+            if (!open(x + stepX, y) || !open(x, y + stepY)) return false;
+            x += stepX;
+            y += stepY;
+            error += 2 * (dx - dy);
+        }
+    }
+}
+
+void Pathfinder::smoothPath(const TileMap& map, sf::Vector2i start, std::vector<sf::Vector2i>& path) {
+    if (path.size() < 2) return;
+
+    // 原地压缩：out 之前是已确定的拐点
+    std::size_t out = 0;
+    sf::Vector2i anchor = start;
+    for (std::size_t i = 0; i + 1 < path.size(); ++i) {
+        // 从锚点看不到下一个点，当前点就是必须保留的拐角
+        sf::Vector2i next = path[i + 1];
+        int maxCost = std::max(map.stepCost(anchor.y, anchor.x), map.stepCost(next.y, next.x));
+        if (!lineOfSight(map, anchor, next, maxCost)) {
+            anchor = path[i];
+            path[out++] = anchor;
+        }
+    }
+    path[out++] = path.back(); // 终点总是保留
+    path.resize(out);
+}
+
+// ======================= 距离场 =======================
+
+bool DistanceField::nextStep(sf::Vector2i from, sf::Vector2i& to) const {
+    if (from.x < 0 || from.x >= cols || from.y < 0 || from.y >= rows) return false;
+    std::uint32_t best = at(from.y, from.x);
+    if (best == 0 || best == UNREACHABLE) return false;
+
+    const int dr[] = {-1, 1, 0, 0};
+    const int dc[] = {0, 0, -1, 1};
+    bool found = false;
+    for (int i = 0; i < 4; i++) {
+        int r = from.y + dr[i];
+        int c = from.x + dc[i];
+        if (r < 0 || r >= rows || c < 0 || c >= cols) continue;
+        if (at(r, c) < best) {
+            best = at(r, c);
+            to = sf::Vector2i(c, r);
+            found = true;
+        }
+    }
+    return found;
+}
+
+void Pathfinder::buildDistanceField(
+    const TileMap& map,
+    const std::vector<sf::Vector2i>& goals,
+    DistanceField& field
+) {
+    const int rows = map.rows();
+    const int cols = map.cols();
+    const int words = map.wordsPerRow();
+    const std::size_t bitmapSize = static_cast<std::size_t>(rows + 2) * words;
+
+    field.rows = rows;
+    field.cols = cols;
+    field.dist.assign(static_cast<std::size_t>(rows) * cols, DistanceField::UNREACHABLE);
+    // 三张位图与地图位图同布局 (含哨兵行)，assign 在容量足够时不会重新分配
+    field.frontier.assign(bitmapSize, 0ull);
+    field.next.assign(bitmapSize, 0ull);
+    field.visited.assign(bitmapSize, 0ull);
+
+    auto rowOf = [words](std::vector<std::uint64_t>& bits, int r) { return bits.data() + (r + 1) * words; };
+
+    // 1. 目标格作为第 0 圈
+    int rowMin = rows, rowMax = -1;
+    for (const auto& g : goals) {
+        if (!map.isPassable(g.y, g.x)) continue;
+        unsigned bit = static_cast<unsigned>(g.x + 1);
+        rowOf(field.frontier, g.y)[bit >> 6] |= 1ull << (bit & 63);
+        rowOf(field.visited, g.y)[bit >> 6] |= 1ull << (bit & 63);
+        field.dist[g.y * cols + g.x] = 0;
+        rowMin = std::min(rowMin, g.y);
+        rowMax = std::max(rowMax, g.y);
+    }
+
+    // 推迟到达的加权格：键是它的距离 (碰到时就确定了，之后不会更短)
+    BucketQueue& delayed = threadQueue();
+    const bool weighted = !map.isUniformCost();
+
+    // 2. 逐圈扩展，直到没有新格子
+    // 第 d 圈：波前是距离 d - 1 的格子，碰到的平价格距离为 d，加权格距离为 d - 1 + 代价
+    // 不变式：next 全为 0；frontier 只有 [rowMin, rowMax] 行可能非 0
+    for (std::uint32_t d = 1; rowMin <= rowMax || !delayed.empty(); ++d) {
+        // 距离 d - 1 的加权格到时间了，并入波前
+        while (!delayed.empty() && delayed.minKey() == d - 1) {
+            std::uint32_t key;
+            std::int32_t index = delayed.pop(key);
+            int r = index / cols;
+            unsigned bit = static_cast<unsigned>(index % cols + 1);
+            rowOf(field.frontier, r)[bit >> 6] |= 1ull << (bit & 63);
+            rowMin = std::min(rowMin, r);
+            rowMax = std::max(rowMax, r);
+        }
+
+        int lo = std::max(0, rowMin - 1);
+        int hi = std::min(rows - 1, rowMax + 1);
+        int newMin = rows, newMax = -1;
+
+        for (int r = lo; r <= hi; ++r) {
+            const std::uint64_t* up = rowOf(field.frontier, r - 1);
+            const std::uint64_t* cur = rowOf(field.frontier, r);
+            const std::uint64_t* down = rowOf(field.frontier, r + 1);
+            const std::uint64_t* pass = map.passableRow(r);
+            std::uint64_t* vis = rowOf(field.visited, r);
+            std::uint64_t* out = rowOf(field.next, r);
+
+            bool any = false;
+            for (int w = 0; w < words; ++w) {
+                std::uint64_t f = cur[w];
+                // 左右邻居：整字移位，跨字的那一位从相邻字借过来
+                std::uint64_t fromLeft = (f << 1) | (w > 0 ? cur[w - 1] >> 63 : 0ull);
+                std::uint64_t fromRight = (f >> 1) | (w + 1 < words ? cur[w + 1] << 63 : 0ull);
+                std::uint64_t reached = (fromLeft | fromRight | up[w] | down[w]) & pass[w] & ~vis[w];
+                if (!reached) continue;
+
+                vis[w] |= reached;
+                std::uint32_t* distRow = field.dist.data() + static_cast<std::size_t>(r) * cols;
+
+                // 加权格单独记距离、推迟入波前
+                if (weighted) {
+                    std::uint64_t heavy = reached & map.weightedRow(r)[w];
+                    reached &= ~heavy;
+                    while (heavy) {
+                        int bit = ctz64(heavy);
+                        int c = w * 64 + bit - 1;
+                        std::uint32_t dist = d - 1 + static_cast<std::uint32_t>(map.stepCost(r, c));
+                        distRow[c] = dist;
+                        delayed.push(dist, r * cols + c);
+                        heavy &= heavy - 1;
+                    }
+                    if (!reached) continue;
+                }
+
+                out[w] = reached;
+                any = true;
+
+                // 只对新到达的格子写距离 (每格一生只写一次)
+                while (reached) {
+                    int bit = ctz64(reached);
+                    distRow[w * 64 + bit - 1] = d; // 第 0 位是左哨兵列
+                    reached &= reached - 1;
+                }
+            }
+            if (any) {
+                newMin = std::min(newMin, r);
+                newMax = std::max(newMax, r);
+            }
+        }
+
+        // 清掉旧波前，交换后 next 重新全为 0
+        for (int r = rowMin; r <= rowMax; ++r) {
+            std::uint64_t* old = rowOf(field.frontier, r);
+            std::fill(old, old + words, 0ull);
+        }
+        field.frontier.swap(field.next);
+        rowMin = newMin;
+        rowMax = newMax;
+    }
+}
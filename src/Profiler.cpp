@@ -0,0 +1,199 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace {
+    struct Event {
+        const char* name;
+        std::uint64_t start;    // 纳秒
+        std::uint64_t duration; // 纳秒
+    };
+
+    // 缓冲里的一格：字段用 relaxed 原子读写 (x86 上就是普通的 mov)，导出线程和写入线程并发访问时没有数据竞争
+    // seq 是这一格的序号锁：写第 i 条时先置 2i+1 (正在写)，写完置 2i+2
+    struct Slot {
+        std::atomic<std::uint64_t> seq;
+        std::atomic<const char*> name;
+        std::atomic<std::uint64_t> start;
+        std::atomic<std::uint64_t> duration;
+    };
+
+    // 一个线程的环形缓冲，只有所属线程写
+    // 读的一方 (导出/汇总) 逐格拷贝，拷贝前后各读一次这一格的序号：
+    // 写满后写入线程正在覆盖的就是最旧的那格，只看总下标分辨不出来，序号对不上的格子直接丢掉
+    struct ThreadBuffer {
+        std::unique_ptr<Slot[]> events{ new Slot[Profiler::RING_CAPACITY] };
+        std::atomic<std::uint64_t> head{ 0 }; // 累计写入的条数
+        std::atomic<const char*> name{ nullptr };
+        int id = 0;
+    };
+
+    // 线程退出后缓冲仍然保留 (导出时还能看到它的记录)
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    };
+
+    Registry& registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    thread_local ThreadBuffer* t_buffer = nullptr;
+
+    ThreadBuffer& localBuffer() {
+        if (!t_buffer) {
+            Registry& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            reg.buffers.push_back(std::make_unique<ThreadBuffer>());
+            t_buffer = reg.buffers.back().get();
+            t_buffer->id = static_cast<int>(reg.buffers.size());
+        }
+        return *t_buffer;
+    }
+
+    // 拷出一个缓冲里仍然有效的记录 (按写入顺序)
+    void snapshot(const ThreadBuffer& buffer, std::vector<Event>& out) {
+        const std::uint64_t cap = Profiler::RING_CAPACITY;
+        std::uint64_t end = buffer.head.load(std::memory_order_acquire);
+        std::uint64_t begin = end > cap ? end - cap : 0;
+        for (std::uint64_t i = begin; i < end; ++i) {
+            const Slot& slot = buffer.events[i & (cap - 1)];
+            std::uint64_t seq = slot.seq.load(std::memory_order_acquire);
+            Event e{ slot.name.load(std::memory_order_relaxed),
+                     slot.start.load(std::memory_order_relaxed),
+                     slot.duration.load(std::memory_order_relaxed) };
+            std::atomic_thread_fence(std::memory_order_acquire);
+            // 拷贝前这一格已经不是第 i 条，或者拷贝期间被改写过：丢掉
+            if (seq != 2 * i + 2 || slot.seq.load(std::memory_order_relaxed) != seq) continue;
+            out.push_back(e);
+        }
+    }
+
+    void writeJsonString(std::FILE* f, const char* s) {
+        std::fputc('"', f);
+        for (; *s; ++s) {
+            if (*s == '"' || *s == '\\') std::fputc('\\', f);
+            std::fputc(*s, f);
+        }
+        std::fputc('"', f);
+    }
+
+    // 汇总窗口：只看最近这么久的记录
+    const std::uint64_t SUMMARY_WINDOW_NS = 10ull * 1000 * 1000 * 1000;
+}
+
+std::uint64_t Profiler::nowNs() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void Profiler::record(const char* name, std::uint64_t startNs, std::uint64_t endNs) {
+    ThreadBuffer& buffer = localBuffer();
+    std::uint64_t index = buffer.head.load(std::memory_order_relaxed);
+    Slot& slot = buffer.events[index & (RING_CAPACITY - 1)];
+    slot.seq.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release); // 读的一方看到新字段时，一定也看得到"正在写"
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start.store(startNs, std::memory_order_relaxed);
+    slot.duration.store(endNs - startNs, std::memory_order_relaxed);
+    slot.seq.store(2 * index + 2, std::memory_order_release);
+    buffer.head.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::setThreadName(const char* name) {
+    localBuffer().name.store(name, std::memory_order_relaxed);
+}
+
+bool Profiler::writeChromeTrace(const std::string& path) {
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) return false;
+
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    // 时间轴从最早的一条记录开始
+    std::vector<std::vector<Event>> perThread(reg.buffers.size());
+    std::uint64_t origin = ~0ull;
+    for (std::size_t t = 0; t < reg.buffers.size(); ++t) {
+        snapshot(*reg.buffers[t], perThread[t]);
+        for (const Event& e : perThread[t]) origin = std::min(origin, e.start);
+    }
+
+    std::fputs("{\"traceEvents\":[\n", f);
+    bool first = true;
+    for (std::size_t t = 0; t < reg.buffers.size(); ++t) {
+        const ThreadBuffer& buffer = *reg.buffers[t];
+        if (const char* name = buffer.name.load(std::memory_order_relaxed)) {
+            std::fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":",
+                         first ? "" : ",\n", buffer.id);
+            writeJsonString(f, name);
+            std::fputs("}}", f);
+            first = false;
+        }
+        for (const Event& e : perThread[t]) {
+            // ts / dur 单位是微秒
+            std::fprintf(f, "%s{\"name\":", first ? "" : ",\n");
+            writeJsonString(f, e.name);
+            std::fprintf(f, ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                         buffer.id, (e.start - origin) / 1000.0, e.duration / 1000.0);
+            first = false;
+        }
+    }
+    std::fputs("\n],\"displayTimeUnit\":\"ms\"}\n", f);
+    bool ok = std::ferror(f) == 0;
+    std::fclose(f);
+    return ok;
+}
+
+std::vector<Profiler::PhaseStats> Profiler::summarize(std::uint64_t sinceNs) {
+    std::vector<Event> events;
+    {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (const auto& buffer : reg.buffers) snapshot(*buffer, events);
+    }
+
+    // 按名字分组 (不同编译单元里同名的字面量可能是不同的指针，按内容比较)
+    std::map<std::string, std::vector<std::uint64_t>> groups;
+    for (const Event& e : events) {
+        if (e.start >= sinceNs) groups[e.name].push_back(e.duration);
+    }
+
+    std::vector<PhaseStats> rows;
+    for (auto& group : groups) {
+        std::vector<std::uint64_t>& d = group.second;
+        std::sort(d.begin(), d.end());
+        std::uint64_t total = 0;
+        for (std::uint64_t v : d) total += v;
+        auto pick = [&d](double q) { return d[static_cast<std::size_t>(q * (d.size() - 1) + 0.5)] / 1e6; };
+        rows.push_back(PhaseStats{ group.first, d.size(), pick(0.50), pick(0.99), d.back() / 1e6, total / 1e6 });
+    }
+    std::sort(rows.begin(), rows.end(), [](const PhaseStats& a, const PhaseStats& b) { return a.total > b.total; });
+    return rows;
+}
+
+void Profiler::printSummary(std::ostream& out) {
+    const std::uint64_t now = nowNs();
+    std::vector<PhaseStats> rows = summarize(now > SUMMARY_WINDOW_NS ? now - SUMMARY_WINDOW_NS : 0);
+
+    char line[160];
+    std::snprintf(line, sizeof(line), "[Profile] last %llu s, per call in ms",
+                  static_cast<unsigned long long>(SUMMARY_WINDOW_NS / 1000000000ull));
+    out << line << '\n';
+    std::snprintf(line, sizeof(line), "  %-22s %8s %9s %9s %9s %10s", "phase", "calls", "p50", "p99", "max", "total");
+    out << line << '\n';
+    for (const PhaseStats& r : rows) {
+        std::snprintf(line, sizeof(line), "  %-22s %8zu %9.3f %9.3f %9.3f %10.1f",
+                      r.name.c_str(), r.calls, r.p50, r.p99, r.max, r.total);
+        out << line << '\n';
+    }
+    out.flush();
+}
@@ -0,0 +1,310 @@
+#include "ProjectileSystem.h"
+#include "Unit.h"
+#include "ResourceManager.h"
+#include "DamageBuffer.h"
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define BATTLESIM_X86_64 1
+#include <immintrin.h>
+#endif
+
+namespace {
+    // 追踪弹不会错过目标，寿命只是兜底
+    const float HOMING_LIFE = 10.f;
+    // 直线飞的子弹过了拦截时间还能再飞这么久，之后算打空
+    const float MISS_GRACE = 0.25f;
+
+    const ProjectileStyle& styleOf(ProjectileKind kind) {
+        return PROJECTILE_STYLES[static_cast<std::size_t>(kind)];
+    }
+}
+
+ProjectileSystem::ProjectileSystem(const UnitHandleTable& units, DamageBuffer& damage)
+    : m_units(units), m_damageBuffer(damage) {
+    for (auto& batch : m_batches) batch.setPrimitiveType(sf::Quads);
+    reserve(INITIAL_CAPACITY);
+}
+
+void ProjectileSystem::reserve(std::size_t capacity) {
+    m_x.reserve(capacity); m_y.reserve(capacity);
+    m_vx.reserve(capacity); m_vy.reserve(capacity);
+    m_speed.reserve(capacity); m_homing.reserve(capacity);
+    m_radius2.reserve(capacity); m_life.reserve(capacity);
+    m_damage.reserve(capacity); m_target.reserve(capacity);
+    m_kind.reserve(capacity); m_alive.reserve(capacity);
+    m_tx.reserve(capacity); m_ty.reserve(capacity);
+    m_hit.reserve(capacity);
+}
+
+float ProjectileSystem::interceptTime(sf::Vector2f from, sf::Vector2f targetPos, sf::Vector2f targetVel, float speed) {
+    // 求最小的 t > 0 使 |r + v*t| = speed * t，即 (v·v - s²)t² + 2(r·v)t + r·r = 0
+    sf::Vector2f r = targetPos - from;
+    float a = targetVel.x * targetVel.x + targetVel.y * targetVel.y - speed * speed;
+    float b = 2.f * (r.x * targetVel.x + r.y * targetVel.y);
+    float c = r.x * r.x + r.y * r.y;
+
+    if (std::fabs(a) < 1e-6f) {
+        // 目标和子弹一样快：退化成一次方程
+        if (b >= 0.f) return -1.f;
+        return -c / b;
+    }
+    float disc = b * b - 4.f * a * c;
+    if (disc < 0.f) return -1.f;
+    float root = std::sqrt(disc);
+    float t1 = (-b - root) / (2.f * a);
+    float t2 = (-b + root) / (2.f * a);
+    if (t1 > t2) std::swap(t1, t2);
+    if (t1 > 0.f) return t1;
+    if (t2 > 0.f) return t2;
+    return -1.f;
+}
+
+void ProjectileSystem::spawn(sf::Vector2f pos, const Unit* target, float damage, ProjectileKind kind) {
+    const ProjectileStyle& style = styleOf(kind);
+    sf::Vector2f aim = pos;
+    float life = HOMING_LIFE;
+
+    if (target) {
+        sf::Vector2f targetPos = target->getPosition();
+        aim = targetPos;
+        if (!style.homing) {
+            // 提前量：瞄准拦截点；追不上就瞄准当前位置
+            float t = interceptTime(pos, targetPos, target->getVelocity(), style.speed);
+            if (t > 0.f) {
+                aim = targetPos + target->getVelocity() * t;
+            } else {
+                sf::Vector2f d = targetPos - pos;
+                t = std::sqrt(d.x * d.x + d.y * d.y) / style.speed;
+            }
+            life = t + MISS_GRACE;
+        }
+    }
+
+    // 初速度指向瞄准点 (重合时给个默认方向，第一帧就会命中)
+    sf::Vector2f dir = aim - pos;
+    float len = std::sqrt(dir.x * dir.x + dir.y * dir.y);
+    dir = len > 1e-3f ? dir / len : sf::Vector2f(1.f, 0.f);
+
+    m_x.push_back(pos.x);
+    m_y.push_back(pos.y);
+    m_vx.push_back(dir.x * style.speed);
+    m_vy.push_back(dir.y * style.speed);
+    m_speed.push_back(style.speed);
+    m_homing.push_back(style.homing ? 1.f : 0.f);
+    m_radius2.push_back(style.hitRadius * style.hitRadius);
+    m_life.push_back(life);
+    m_damage.push_back(damage);
+    m_target.push_back(target ? target->getHandle() : UnitHandle());
+    m_kind.push_back(kind);
+    m_alive.push_back(1);
+}
+
+void ProjectileSystem::clear() {
+    m_x.clear(); m_y.clear();
+    m_vx.clear(); m_vy.clear();
+    m_speed.clear(); m_homing.clear();
+    m_radius2.clear(); m_life.clear();
+    m_damage.clear(); m_target.clear();
+    m_kind.clear(); m_alive.clear();
+}
+
+void ProjectileSystem::update(float dt) {
+    const std::size_t n = m_x.size();
+    if (n == 0) return;
+    m_tx.resize(n);
+    m_ty.resize(n);
+    m_hit.resize(n);
+
+    // 1. 收集目标位置 (唯一需要解引用单位的一步)
+    // 目标已被删除或已经死亡：子弹失效。把目标点设成子弹自己的位置，后面的批量计算照常跑
+    for (std::size_t i = 0; i < n; ++i) {
+        const Unit* target = m_units.get(m_target[i]);
+        if (!target || target->isDead()) {
+            m_alive[i] = 0;
+            m_tx[i] = m_x[i];
+            m_ty[i] = m_y[i];
+            continue;
+        }
+        sf::Vector2f pos = target->getPosition();
+        m_tx[i] = pos.x;
+        m_ty[i] = pos.y;
+    }
+
+    // 2. 转向 + 扫掠命中 + 积分 (批量)
+    integrate(dt);
+
+    // 3. 提交命中的伤害 (帧末统一结算)，更新寿命
+    for (std::size_t i = 0; i < n; ++i) {
+        if (!m_alive[i]) continue;
+        if (m_hit[i]) {
+            m_damageBuffer.submit(m_units.get(m_target[i]), m_damage[i]);
+            m_alive[i] = 0;
+        } else {
+            m_life[i] -= dt;
+            if (m_life[i] <= 0.f) m_alive[i] = 0; // 打空了
+        }
+    }
+
+    // 4. 清掉失效的子弹
+    compact();
+}
+
+void ProjectileSystem::integrate(float dt) {
+    // 每颗子弹：
+    //   追踪的把速度转向目标 (v = 单位方向 * 速率)，直线的保持原速度 (按 m_homing 混合)
+    //   本帧线段 seg = v*dt，求线段上离目标最近的点，距离小于命中半径就算命中 (不再移动)
+    //   没命中的沿线段走完
+    const int n = static_cast<int>(m_x.size());
+    const float minLen2 = 1e-6f; // 避免除零
+    float* x = m_x.data();
+    float* y = m_y.data();
+    float* vx = m_vx.data();
+    float* vy = m_vy.data();
+    const float* speed = m_speed.data();
+    const float* homing = m_homing.data();
+    const float* radius2 = m_radius2.data();
+    const float* tx = m_tx.data();
+    const float* ty = m_ty.data();
+    std::uint8_t* hit = m_hit.data();
+
+    int i = 0;
+#ifdef BATTLESIM_X86_64
+    // 一次 4 颗
+    const __m128 vdt = _mm_set1_ps(dt);
+    const __m128 vmin = _mm_set1_ps(minLen2);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.f);
+    for (; i + 4 <= n; i += 4) {
+        __m128 px = _mm_loadu_ps(x + i);
+        __m128 py = _mm_loadu_ps(y + i);
+        __m128 rx = _mm_sub_ps(_mm_loadu_ps(tx + i), px);
+        __m128 ry = _mm_sub_ps(_mm_loadu_ps(ty + i), py);
+        __m128 r2 = _mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(ry, ry));
+
+        // 转向：v += h * (指向目标的速度 - v)
+        __m128 scale = _mm_div_ps(_mm_loadu_ps(speed + i), _mm_sqrt_ps(_mm_max_ps(r2, vmin)));
+        __m128 h = _mm_loadu_ps(homing + i);
+        __m128 ovx = _mm_loadu_ps(vx + i);
+        __m128 ovy = _mm_loadu_ps(vy + i);
+        __m128 nvx = _mm_add_ps(ovx, _mm_mul_ps(h, _mm_sub_ps(_mm_mul_ps(rx, scale), ovx)));
+        __m128 nvy = _mm_add_ps(ovy, _mm_mul_ps(h, _mm_sub_ps(_mm_mul_ps(ry, scale), ovy)));
+        _mm_storeu_ps(vx + i, nvx);
+        _mm_storeu_ps(vy + i, nvy);
+
+        // 扫掠：s = clamp(r·seg / |seg|², 0, 1)，最近点到目标的距离
+        __m128 sx = _mm_mul_ps(nvx, vdt);
+        __m128 sy = _mm_mul_ps(nvy, vdt);
+        __m128 seg2 = _mm_max_ps(_mm_add_ps(_mm_mul_ps(sx, sx), _mm_mul_ps(sy, sy)), vmin);
+        __m128 s = _mm_div_ps(_mm_add_ps(_mm_mul_ps(rx, sx), _mm_mul_ps(ry, sy)), seg2);
+        s = _mm_min_ps(_mm_max_ps(s, zero), one);
+        __m128 cx = _mm_sub_ps(rx, _mm_mul_ps(sx, s));
+        __m128 cy = _mm_sub_ps(ry, _mm_mul_ps(sy, s));
+        __m128 c2 = _mm_add_ps(_mm_mul_ps(cx, cx), _mm_mul_ps(cy, cy));
+        __m128 hitMask = _mm_cmplt_ps(c2, _mm_loadu_ps(radius2 + i));
+
+        // 命中的这一帧不再移动
+        _mm_storeu_ps(x + i, _mm_add_ps(px, _mm_andnot_ps(hitMask, sx)));
+        _mm_storeu_ps(y + i, _mm_add_ps(py, _mm_andnot_ps(hitMask, sy)));
+
+        int bits = _mm_movemask_ps(hitMask);
+        hit[i + 0] = static_cast<std::uint8_t>(bits & 1);
+        hit[i + 1] = static_cast<std::uint8_t>((bits >> 1) & 1);
+        hit[i + 2] = static_cast<std::uint8_t>((bits >> 2) & 1);
+        hit[i + 3] = static_cast<std::uint8_t>((bits >> 3) & 1);
+    }
+#endif
+    // 尾部 (以及非 x86-64 平台的全部)
+    for (; i < n; ++i) {
+        float rx = tx[i] - x[i];
+        float ry = ty[i] - y[i];
+        float r2 = rx * rx + ry * ry;
+        float scale = speed[i] / std::sqrt(r2 > minLen2 ? r2 : minLen2);
+        vx[i] += homing[i] * (rx * scale - vx[i]);
+        vy[i] += homing[i] * (ry * scale - vy[i]);
+
+        float sx = vx[i] * dt;
+        float sy = vy[i] * dt;
+        float seg2 = sx * sx + sy * sy;
+        float s = (rx * sx + ry * sy) / (seg2 > minLen2 ? seg2 : minLen2);
+        s = s < 0.f ? 0.f : (s > 1.f ? 1.f : s);
+        float cx = rx - sx * s;
+        float cy = ry - sy * s;
+        hit[i] = cx * cx + cy * cy < radius2[i];
+        if (!hit[i]) {
+            x[i] += sx;
+            y[i] += sy;
+        }
+    }
+}
+
+void ProjectileSystem::compact() {
+    const std::size_t n = m_x.size();
+    std::size_t w = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (!m_alive[i]) continue;
+        if (w != i) {
+            m_x[w] = m_x[i]; m_y[w] = m_y[i];
+            m_vx[w] = m_vx[i]; m_vy[w] = m_vy[i];
+            m_speed[w] = m_speed[i]; m_homing[w] = m_homing[i];
+            m_radius2[w] = m_radius2[i]; m_life[w] = m_life[i];
+            m_damage[w] = m_damage[i]; m_target[w] = m_target[i];
+            m_kind[w] = m_kind[i];
+            m_alive[w] = 1;
+        }
+        ++w;
+    }
+    if (w == n) return;
+    // 缩小 size 不释放容量
+    m_x.resize(w); m_y.resize(w);
+    m_vx.resize(w); m_vy.resize(w);
+    m_speed.resize(w); m_homing.resize(w);
+    m_radius2.resize(w); m_life.resize(w);
+    m_damage.resize(w); m_target.resize(w);
+    m_kind.resize(w); m_alive.resize(w);
+}
+
+void ProjectileSystem::render(sf::RenderTarget& target, const sf::FloatRect& visible) {
+    for (auto& batch : m_batches) batch.clear();
+    ResourceManager& resources = ResourceManager::getInstance();
+
+    for (std::size_t i = 0; i < m_x.size(); ++i) {
+        sf::Vector2f p(m_x[i], m_y[i]);
+        if (!visible.contains(p)) continue;
+
+        const std::size_t k = static_cast<std::size_t>(m_kind[i]);
+        const ProjectileStyle& style = PROJECTILE_STYLES[k];
+        sf::FloatRect tex(static_cast<float>(style.left), static_cast<float>(style.top),
+                          static_cast<float>(style.width), static_cast<float>(style.height));
+        if (style.width == 0) {
+            sf::Vector2u size = resources.getTexture(style.texture).getSize();
+            tex = sf::FloatRect(0.f, 0.f, static_cast<float>(size.x), static_cast<float>(size.y));
+        }
+        float hx = tex.width * style.scale / 2.f;
+        float hy = tex.height * style.scale / 2.f;
+
+        // 旋转只需要飞行方向的单位向量，不用三角函数
+        float cx = 1.f, cy = 0.f;
+        if (style.rotates) {
+            float len = std::sqrt(m_vx[i] * m_vx[i] + m_vy[i] * m_vy[i]);
+            if (len > 1e-3f) {
+                cx = m_vx[i] / len;
+                cy = m_vy[i] / len;
+            }
+        }
+        auto corner = [&](float lx, float ly) {
+            return sf::Vector2f(p.x + lx * cx - ly * cy, p.y + lx * cy + ly * cx);
+        };
+
+        sf::VertexArray& batch = m_batches[k];
+        batch.append(sf::Vertex(corner(-hx, -hy), sf::Vector2f(tex.left, tex.top)));
+        batch.append(sf::Vertex(corner(hx, -hy), sf::Vector2f(tex.left + tex.width, tex.top)));
+        batch.append(sf::Vertex(corner(hx, hy), sf::Vector2f(tex.left + tex.width, tex.top + tex.height)));
+        batch.append(sf::Vertex(corner(-hx, hy), sf::Vector2f(tex.left, tex.top + tex.height)));
+    }
+
+    for (std::size_t k = 0; k < static_cast<std::size_t>(ProjectileKind::COUNT); ++k) {
+        if (m_batches[k].getVertexCount() == 0) continue;
+        target.draw(m_batches[k], sf::RenderStates(&resources.getTexture(PROJECTILE_STYLES[k].texture)));
+    }
+}
@@ -1,147 +1,208 @@
 #include "ResourceManager.h"
+#include "AssetManifest.h"
 #include <iostream>
 #include <filesystem>
+#include <chrono>
+#include <iterator>
 
 ResourceManager& ResourceManager::getInstance() {
     static ResourceManager instance;
     return instance;
 }
 
-void ResourceManager::loadTexture(const std::string& name, const std::string& fileName) {
-    // 检查是否已经加载过，防止重复加载
-    if (m_textures.find(name) != m_textures.end()) {
-        return; 
-    }
+ResourceManager::ResourceManager()
+    : m_asyncStarted(false), m_criticalTotal(0), m_criticalDone(0)
+{
+    for (auto& ready : m_soundReady) ready = false;
+}
 
-    sf::Texture tex;
-    if (tex.loadFromFile(fileName)) {
-        m_textures[name] = tex;
-        std::cout << "[ResourceManager] Loaded Texture: " << fileName << " as '" << name << "'" << std::endl;
-    } else {
-        std::cerr << "[ResourceManager] ERROR: Failed to load Texture: " << fileName << std::endl;
-
-        // 检查文件到底存不存在
-        if (!std::filesystem::exists(fileName)) {
-            std::cerr << "    -> Reason: File does NOT exist at path!" << std::endl;
-            std::cerr << "    -> Absolute Path: " << std::filesystem::absolute(fileName).string() << std::endl;
-        } else {
-            std::cerr << "    -> Reason: File exists but load failed (format error?)" << std::endl;
-        }
+ResourceManager::~ResourceManager() {
+    // 先等后台任务结束，再析构它们正在写入的资源
+    m_loaderPool.reset();
+}
 
-        // [重要] 创建一个 32x32 的品红色方块作为“错误占位符”
-        // 这样即使图没加载出来，游戏也能运行，你能看到紫色的方块
-        sf::Image errorImage;
-        errorImage.create(32, 32, sf::Color::Magenta);
-        tex.loadFromImage(errorImage);
-        m_textures[name] = tex; // 存入占位图 
-    }
+void ResourceManager::makePlaceholder(sf::Texture& tex) {
+    // [重要] 创建一个 32x32 的品红色方块作为“错误占位符”
+    // 这样即使图没加载出来，游戏也能运行，你能看到紫色的方块
+    sf::Image errorImage;
+    errorImage.create(32, 32, sf::Color::Magenta);
+    tex.loadFromImage(errorImage);
+}
+
+void ResourceManager::waitForSound(std::size_t index) {
+    // 没有启动过加载 (例如无窗口的测试程序)，直接返回空缓冲，不能死等
+    if (!m_asyncStarted) return;
+
+    std::unique_lock<std::mutex> lock(m_loadMutex);
+    m_soundReadyCv.wait(lock, [this, index] { return m_soundReady[index].load(); });
+}
+
+bool ResourceManager::mountArchive(const std::string& fileName) {
+    if (m_archive.isOpen()) return true;
+    if (!m_archive.open(fileName)) return false;
+    std::cout << "[ResourceManager] Mounted archive: " << fileName << std::endl;
+    return true;
 }
 
-sf::Texture& ResourceManager::getTexture(const std::string& name) {
-    if (m_textures.find(name) == m_textures.end()) {
-        std::cerr << "[ResourceManager] CRITICAL: Texture not found: " << name << std::endl;
-        // 如果找不到，为了不让程序直接崩溃，这里可能会抛出异常或者返回一个默认的空纹理
-        // 这里简单处理：直接抛出异常，强迫开发者修复路径错误
-        throw std::runtime_error("Texture not found: " + name);
+bool ResourceManager::loadFromArchive(const AssetEntry& entry) {
+    if (!m_archive.isOpen()) return false;
+    const PakEntry* pak = m_archive.find(entry.name);
+    if (!pak || pak->kind != static_cast<std::uint32_t>(entry.kind)) return false;
+
+    const std::uint8_t* bytes = m_archive.data(*pak);
+    bool ok = false;
+
+    switch (entry.kind) {
+        case AssetKind::TEXTURE: {
+            // 预解码的 RGBA：创建纹理后直接从映射内存上传
+            sf::Texture& tex = m_textures[entry.index];
+            ok = tex.create(pak->param0, pak->param1);
+            if (ok) tex.update(bytes);
+            break;
+        }
+        case AssetKind::SOUND:
+            // 预解码的 PCM：只是一次内存拷贝进 OpenAL 缓冲
+            ok = m_soundBuffers[entry.index].loadFromSamples(
+                reinterpret_cast<const sf::Int16*>(bytes), pak->param2, pak->param0, pak->param1);
+            break;
+        case AssetKind::FONT:
+            // sf::Font 会一直引用这块内存，所以包要映射到程序结束
+            ok = m_fonts[entry.index].loadFromMemory(bytes, static_cast<std::size_t>(pak->dataSize));
+            break;
     }
-    return m_textures.at(name);
+    return ok;
 }
 
-void ResourceManager::loadSoundBuffer(const std::string& name, const std::string& fileName) {
-    if (m_soundBuffers.find(name) != m_soundBuffers.end()) {
-        return;
+void ResourceManager::startAsyncLoad() {
+    if (m_asyncStarted) return;
+    m_asyncStarted = true;
+
+    std::cout << "--- Loading Assets (async) ---" << std::endl;
+    m_loaderPool = std::make_unique<ThreadPool>();
+
+    // 优先使用打包资源，没有包时回退到逐个解码散文件
+    mountArchive("assets.pak");
+
+    // 1. 统计关键资源数 (进度条用)
+    for (const auto& entry : ASSET_MANIFEST) {
+        if (entry.critical) m_criticalTotal++;
     }
 
-    sf::SoundBuffer buffer;
-    if (buffer.loadFromFile(fileName)) {
-        m_soundBuffers[name] = buffer;
-        std::cout << "[ResourceManager] Loaded Sound: " << fileName << " as '" << name << "'" << std::endl;
-    } else {
-        std::cerr << "[ResourceManager] ERROR: Failed to load Sound: " << fileName << std::endl;
+    // 包里有的资源直接在主线程创建 (没有解码工作，只有内存拷贝)
+    std::vector<const AssetEntry*> fromFiles;
+    for (const auto& entry : ASSET_MANIFEST) {
+        if (loadFromArchive(entry)) {
+            if (entry.critical) m_criticalDone++;
+            if (entry.kind == AssetKind::SOUND) {
+                m_soundReady[entry.index] = true;
+            }
+        } else {
+            fromFiles.push_back(&entry);
+        }
+    }
+    if (m_archive.isOpen()) {
+        std::cout << "[ResourceManager] " << (std::size(ASSET_MANIFEST) - fromFiles.size())
+                  << " assets loaded from archive, " << fromFiles.size() << " from loose files" << std::endl;
     }
-}
 
-sf::SoundBuffer& ResourceManager::getSoundBuffer(const std::string& name) {
-    if (m_soundBuffers.find(name) == m_soundBuffers.end()) {
-        std::cerr << "[ResourceManager] CRITICAL: SoundBuffer not found: " << name << std::endl;
-        throw std::runtime_error("SoundBuffer not found: " + name);
+    // 2. 剩下的提交解码任务：关键资源先提交，线程池按 FIFO 执行，音频自然排在后面
+    for (int pass = 0; pass < 2; ++pass) {
+        bool wantCritical = (pass == 0);
+        for (const AssetEntry* e : fromFiles) {
+            const AssetEntry& entry = *e;
+            if (entry.critical != wantCritical) continue;
+
+            std::size_t index = entry.index;
+            std::string name = entry.name;
+            std::string fileName = entry.path;
+
+            switch (entry.kind) {
+                case AssetKind::TEXTURE:
+                    // 后台只做读文件 + PNG 解码，纹理上传必须在有 GL 上下文的主线程
+                    m_loaderPool->submit([this, index, fileName, critical = entry.critical] {
+                        DecodedImage decoded;
+                        decoded.index = index;
+                        decoded.fileName = fileName;
+                        decoded.critical = critical;
+                        decoded.ok = decoded.image.loadFromFile(fileName);
+                        std::lock_guard<std::mutex> lock(m_loadMutex);
+                        m_decodedImages.push_back(std::move(decoded));
+                    });
+                    break;
+
+                case AssetKind::FONT:
+                    m_loaderPool->submit([this, index, name, fileName, critical = entry.critical] {
+                        if (m_fonts[index].loadFromFile(fileName)) {
+                            std::cout << "[ResourceManager] Loaded Font: " << fileName << " as '" << name << "'" << std::endl;
+                        } else {
+                            std::cerr << "[ResourceManager] ERROR: Failed to load Font: " << fileName << std::endl;
+                        }
+                        if (critical) m_criticalDone++;
+                    });
+                    break;
+
+                case AssetKind::SOUND:
+                    m_loaderPool->submit([this, index, name, fileName] {
+                        // OGG 解码是启动最慢的部分，放在后台并行做
+                        if (m_soundBuffers[index].loadFromFile(fileName)) {
+                            std::cout << "[ResourceManager] Loaded Sound: " << fileName << " as '" << name << "'" << std::endl;
+                        } else {
+                            std::cerr << "[ResourceManager] ERROR: Failed to load Sound: " << fileName << std::endl;
+                        }
+                        {
+                            // 持锁写入，避免和 waitForSound 的检查错过通知
+                            std::lock_guard<std::mutex> lock(m_loadMutex);
+                            m_soundReady[index].store(true, std::memory_order_release);
+                        }
+                        m_soundReadyCv.notify_all();
+                    });
+                    break;
+            }
+        }
     }
-    return m_soundBuffers.at(name);
 }
 
-// 字体加载实现
-void ResourceManager::loadFont(const std::string& name, const std::string& fileName) {
-    if (m_fonts.find(name) != m_fonts.end()) return;
+bool ResourceManager::pumpUploads() {
+    // 取出目前已解码的图片 (持锁时间尽量短)
+    std::vector<DecodedImage> ready;
+    {
+        std::lock_guard<std::mutex> lock(m_loadMutex);
+        ready.swap(m_decodedImages);
+    }
 
-    sf::Font font;
-    if (font.loadFromFile(fileName)) {
-        m_fonts[name] = font;
-        std::cout << "[ResourceManager] Loaded Font: " << fileName << " as '" << name << "'" << std::endl;
-    } else {
-        std::cerr << "[ResourceManager] ERROR: Failed to load Font: " << fileName << std::endl;
+    // 在主线程上传 GPU 纹理
+    for (auto& decoded : ready) {
+        sf::Texture& tex = m_textures[decoded.index];
+        if (decoded.ok && tex.loadFromImage(decoded.image)) {
+            std::cout << "[ResourceManager] Loaded Texture: " << decoded.fileName << std::endl;
+        } else {
+            std::cerr << "[ResourceManager] ERROR: Failed to load Texture: " << decoded.fileName << std::endl;
+            if (!std::filesystem::exists(decoded.fileName)) {
+                std::cerr << "    -> Reason: File does NOT exist at path!" << std::endl;
+                std::cerr << "    -> Absolute Path: " << std::filesystem::absolute(decoded.fileName).string() << std::endl;
+            }
+            makePlaceholder(tex);
+        }
+        if (decoded.critical) m_criticalDone++;
     }
+
+    return m_criticalDone >= m_criticalTotal;
 }
 
-sf::Font& ResourceManager::getFont(const std::string& name) {
-    if (m_fonts.find(name) == m_fonts.end()) {
-        std::cerr << "[ResourceManager] CRITICAL: Font not found: " << name << std::endl;
-        throw std::runtime_error("Font not found: " + name);
-    }
-    return m_fonts.at(name);
+float ResourceManager::getLoadProgress() const {
+    int total = m_criticalTotal;
+    if (total == 0) return 1.f;
+    return static_cast<float>(m_criticalDone) / total;
 }
 
 void ResourceManager::loadAllAssets() {
-    std::cout << "--- Loading Assets ---" << std::endl;
-
-    // 1. 地图与UI
-    loadTexture("background", "assets/textures/Background.png");
-    loadTexture("main_bg", "assets/textures/mainBackground.png"); // 可能用于菜单
-    loadTexture("ui_heart", "assets/textures/heart.png");
-    loadTexture("ui_elixir", "assets/textures/elixirCost.png");
-    loadTexture("ui_add", "assets/textures/addCard.png");
-    loadTexture("ui_remove", "assets/textures/removeCard.png");
-    loadTexture("vfx_damaged", "assets/textures/damaged_area.png");
-    loadTexture("ui_crown", "assets/textures/life_bar_crown.png");
-    
-    // 2. 投射物
-    loadTexture("bullet", "assets/textures/bullet.png");
-    // 箭矢动画
-    loadTexture("arrow_sheet", "assets/textures/arrows_spritesheet.png");
-
-    // 3. 士兵 (Spritesheets - 动态图)
-    loadTexture("unit_archers", "assets/textures/archers_spritesheet.png");
-    loadTexture("unit_dartgoblin", "assets/textures/dartGoblin_spritesheet.png");
-    loadTexture("unit_giant", "assets/textures/giant_spritesheet.png");
-    loadTexture("unit_knight", "assets/textures/knight_spritesheet.png");
-    loadTexture("unit_pekka", "assets/textures/pekka_spritesheet.png");
-    loadTexture("unit_valkyrie", "assets/textures/valkyrie_spritesheet.png");
-
-    // 4. 士兵 (Static - 卡牌图标/头像)
-    loadTexture("icon_archers", "assets/textures/archers.png");
-    loadTexture("icon_dartgoblin", "assets/textures/dart_goblin.png");
-    loadTexture("icon_giant", "assets/textures/giant.png");
-    loadTexture("icon_knight", "assets/textures/knight.png");
-    loadTexture("icon_pekka", "assets/textures/pekka.png");
-    loadTexture("icon_valkyrie", "assets/textures/valkyrie.png");
-
-    // 5. 音频 - 部署 (Deploy)
-    loadSoundBuffer("sfx_deploy_archers", "assets/audio/archers_deploy_sound.ogg");
-    loadSoundBuffer("sfx_deploy_dartgoblin", "assets/audio/dartgoblin_deploy_sound.ogg");
-    loadSoundBuffer("sfx_deploy_giant", "assets/audio/giant_deploy_sound.ogg");
-    loadSoundBuffer("sfx_deploy_knight", "assets/audio/knight_deploy_sound.ogg");
-    loadSoundBuffer("sfx_deploy_pekka", "assets/audio/pekka_deploy_sound.ogg");
-    loadSoundBuffer("sfx_deploy_valkyrie", "assets/audio/valkyrie_deploy_sound.ogg");
-
-    // 6. 音频 - 攻击/受击 (Hit)
-    loadSoundBuffer("sfx_hit_archers", "assets/audio/archers_hit_sound.ogg");
-    loadSoundBuffer("sfx_hit_dartgoblin", "assets/audio/dartgoblin_hit_sound.ogg");
-    loadSoundBuffer("sfx_hit_giant", "assets/audio/giant_hit_sound.ogg");
-    loadSoundBuffer("sfx_hit_knight", "assets/audio/knight_hit_sound.ogg");
-    loadSoundBuffer("sfx_hit_pekka", "assets/audio/pekka_hit_sound.ogg");
-    loadSoundBuffer("sfx_hit_valkyrie", "assets/audio/valkyrie_hit_sound.ogg");
-
-    // 6. 加载字体
-    loadFont("main_font", "assets/fonts/Supercell_Magic_Regular.ttf");
+    startAsyncLoad();
+
+    // 同步版本：上传所有纹理，再等后台把音频也解码完
+    while (!pumpUploads()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    m_loaderPool->waitIdle();
 
     std::cout << "--- Assets Loading Complete ---" << std::endl;
-}
\ No newline at end of file
+}
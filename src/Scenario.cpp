@@ -0,0 +1,193 @@
+#include "Scenario.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include "Unit.h"
+
+namespace {
+    struct UnitInfo {
+        UnitType type;
+        const char* name;
+        int rank; // 方阵里的排序：越小越靠前
+    };
+
+    const UnitInfo UNIT_INFOS[] = {
+        { UnitType::GIANT,       "giant",       0 },
+        { UnitType::PEKKA,       "pekka",       1 },
+        { UnitType::KNIGHT,      "knight",      2 },
+        { UnitType::VALKYRIE,    "valkyrie",    3 },
+        { UnitType::ARCHERS,     "archers",     4 },
+        { UnitType::DART_GOBLIN, "dart_goblin", 5 },
+    };
+
+    const UnitInfo& infoOf(UnitType type) {
+        for (const auto& info : UNIT_INFOS) {
+            if (info.type == type) return info;
+        }
+        return UNIT_INFOS[0];
+    }
+
+    // 按权重把 total 个名额分给各兵种 (最大余数法，总数严格等于 total)
+    std::vector<int> splitByWeight(const std::vector<ScenarioSquad>& mix, int total) {
+        int weightSum = 0;
+        for (const auto& s : mix) weightSum += s.weight;
+        std::vector<int> counts(mix.size(), 0);
+        if (weightSum <= 0 || total <= 0) return counts;
+
+        std::vector<std::pair<long long, std::size_t>> remainders;
+        int assigned = 0;
+        for (std::size_t i = 0; i < mix.size(); ++i) {
+            long long scaled = static_cast<long long>(total) * mix[i].weight;
+            counts[i] = static_cast<int>(scaled / weightSum);
+            assigned += counts[i];
+            remainders.push_back({ scaled % weightSum, i });
+        }
+        std::sort(remainders.begin(), remainders.end(),
+                  [](const auto& a, const auto& b) { return a.first != b.first ? a.first > b.first : a.second < b.second; });
+        for (std::size_t i = 0; assigned < total; ++i, ++assigned) counts[remainders[i % remainders.size()].second]++;
+        return counts;
+    }
+
+    // 该队的前沿在哪一行：敌方塔的平均行 (没有塔时取对面的地图边)
+    float frontRow(const MapData& map, int team) {
+        float sum = 0.f;
+        int count = 0;
+        for (const auto& t : map.towers) {
+            if (t.team != team) {
+                sum += static_cast<float>(t.row);
+                count++;
+            }
+        }
+        if (count > 0) return sum / count;
+        return team == TEAM_A ? static_cast<float>(map.tiles.rows() - 1) : 0.f;
+    }
+}
+
+bool Scenario::parseMix(const std::string& text, std::vector<ScenarioSquad>& out) {
+    out.clear();
+    std::istringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty()) continue;
+        std::size_t colon = item.find(':');
+        std::string name = item.substr(0, colon);
+        int weight = 1;
+        if (colon != std::string::npos) {
+            weight = std::atoi(item.c_str() + colon + 1);
+            if (weight <= 0) {
+                std::cerr << "[Scenario] Bad weight in '" << item << "'" << std::endl;
+                return false;
+            }
+        }
+        const UnitInfo* found = nullptr;
+        for (const auto& info : UNIT_INFOS) {
+            if (name == info.name) found = &info;
+        }
+        if (!found) {
+            std::cerr << "[Scenario] Unknown unit '" << name << "'" << std::endl;
+            return false;
+        }
+        out.push_back({ found->type, weight });
+    }
+    return true;
+}
+
+bool Scenario::parseLayout(const std::string& text, ScenarioLayout& out) {
+    if (text == "random") { out = ScenarioLayout::RANDOM; return true; }
+    if (text == "formation") { out = ScenarioLayout::FORMATION; return true; }
+    std::cerr << "[Scenario] Unknown layout '" << text << "' (random | formation)" << std::endl;
+    return false;
+}
+
+const char* Scenario::unitName(UnitType type) {
+    return infoOf(type).name;
+}
+
+void Scenario::fitMapSize(int totalUnits, int& rows, int& cols) {
+    int side = static_cast<int>(std::ceil(std::sqrt(std::max(0, totalUnits) * 4.0)));
+    rows = std::max(Game::DEFAULT_ROWS, side);
+    cols = std::max(Game::DEFAULT_COLS, side);
+}
+
+std::size_t Scenario::populate(Game& game, const ScenarioSpec& spec) {
+    const MapData& map = game.map();
+    const int rows = map.tiles.rows();
+    const int cols = map.tiles.cols();
+    const float tile = static_cast<float>(Game::TILE_SIZE);
+    std::mt19937 rng(spec.seed);
+    std::size_t spawned = 0;
+
+    for (int team = 0; team < 2; ++team) {
+        const int total = spec.unitsPerTeam[team];
+        if (total <= 0) continue;
+
+        // 1. 每个兵种的数量，按方阵里的前后排序展开成出场顺序
+        std::vector<ScenarioSquad> mix = spec.mix[team];
+        if (mix.empty()) {
+            for (const auto& info : UNIT_INFOS) mix.push_back({ info.type, 1 });
+        }
+        std::stable_sort(mix.begin(), mix.end(),
+                         [](const ScenarioSquad& a, const ScenarioSquad& b) { return infoOf(a.type).rank < infoOf(b.type).rank; });
+        std::vector<int> counts = splitByWeight(mix, total);
+        std::vector<UnitType> order;
+        order.reserve(total);
+        for (std::size_t i = 0; i < mix.size(); ++i) order.insert(order.end(), counts[i], mix[i].type);
+
+        // 2. 己方可部署的格子
+        std::vector<std::pair<int, int>> cells;
+        for (int r = 0; r < rows; ++r) {
+            for (int c = 0; c < cols; ++c) {
+                if (map.canDeploy(team, r, c)) cells.push_back({ r, c });
+            }
+        }
+        if (cells.empty()) {
+            std::cerr << "[Scenario] Team " << team << " has no deploy cells" << std::endl;
+            continue;
+        }
+
+        // 3. 方阵：中间一条宽约 sqrt(2n) 列的带子里，从前沿往后一排一排填，同一排从中间往两边
+        //    带子里的格子用完了再用带子外的
+        if (spec.layout == ScenarioLayout::FORMATION) {
+            const float front = frontRow(map, team);
+            const float center = (cols - 1) * 0.5f;
+            const float halfWidth = std::ceil(std::sqrt(2.0f * total)) * 0.5f;
+            std::sort(cells.begin(), cells.end(), [&](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+                float ca = std::abs(a.second - center), cb = std::abs(b.second - center);
+                bool bandA = ca <= halfWidth, bandB = cb <= halfWidth;
+                if (bandA != bandB) return bandA;
+                float da = std::abs(a.first - front), db = std::abs(b.first - front);
+                if (da != db) return da < db;
+                if (ca != cb) return ca < cb;
+                return a.second < b.second;
+            });
+        }
+
+        // 4. 逐个生成；格子不够时从头再叠一层，每层在格内错开
+        std::uniform_int_distribution<std::size_t> pickCell(0, cells.size() - 1);
+        std::uniform_real_distribution<float> jitter(0.15f, 0.85f);
+        for (int i = 0; i < total; ++i) {
+            float x, y;
+            if (spec.layout == ScenarioLayout::RANDOM) {
+                const auto& cell = cells[pickCell(rng)];
+                x = (cell.second + jitter(rng)) * tile;
+                y = (cell.first + jitter(rng)) * tile;
+            } else {
+                const auto& cell = cells[i % cells.size()];
+                std::size_t layer = i / cells.size();
+                x = (cell.second + 0.5f) * tile;
+                y = (cell.first + 0.5f) * tile;
+                if (layer > 0) {
+                    float angle = layer * 2.3999632f; // 黄金角，叠放的几层不会落在同一条线上
+                    x += std::cos(angle) * tile * 0.3f;
+                    y += std::sin(angle) * tile * 0.3f;
+                }
+            }
+            game.spawnUnit(order[i], x, y, team);
+            spawned++;
+        }
+    }
+    return spawned;
+}
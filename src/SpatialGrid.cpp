@@ -0,0 +1,113 @@
+#include "SpatialGrid.h"
+#include "Unit.h"
+#include "MortonOrder.h"
+#include <cassert>
+
+SpatialGrid::SpatialGrid() : m_rows(0), m_cols(0), m_blockRows(0), m_blockCols(0) {}
+
+void SpatialGrid::resize(int rows, int cols) {
+    m_rows = rows;
+    m_cols = cols;
+    m_heads.assign(static_cast<std::size_t>(rows) * cols, -1);
+    m_entries.clear();
+    m_touched.clear();
+
+    m_blockRows = (rows + WATCH_BLOCK - 1) / WATCH_BLOCK;
+    m_blockCols = (cols + WATCH_BLOCK - 1) / WATCH_BLOCK;
+    std::size_t blocks = static_cast<std::size_t>(m_blockRows) * m_blockCols;
+    m_watch.assign(blocks * 2, 0);
+    m_alarmed.assign(blocks * 2, 0);
+    m_alarms.clear();
+}
+
+void SpatialGrid::clear() {
+    for (std::int32_t index : m_touched) {
+        m_heads[index] = -1;
+    }
+    m_touched.clear();
+    m_entries.clear(); // 保留容量，稳定后每帧不再分配
+}
+
+void SpatialGrid::insert(Unit* unit, int r, int c) {
+    if (!inBounds(r, c)) return;
+
+    std::int32_t index = r * m_cols + c;
+    if (m_heads[index] < 0) {
+        m_touched.push_back(index);
+    }
+    sf::Vector2f pos = unit->getPosition();
+    m_entries.push_back({ unit, pos.x, pos.y, m_heads[index],
+                          static_cast<std::uint8_t>(unit->getTeam()), unit->isStructure() });
+    m_heads[index] = static_cast<std::int32_t>(m_entries.size() - 1);
+
+    // 有敌队休眠者盯着这一块 -> 报警
+    std::int32_t block = (r / WATCH_BLOCK) * m_blockCols + c / WATCH_BLOCK;
+    std::int32_t slot = block * 2 + (1 - unit->getTeam());
+    if (m_watch[slot] && !m_alarmed[slot]) {
+        m_alarmed[slot] = 1;
+        m_alarms.push_back(slot);
+    }
+}
+
+void SpatialGrid::sortByCell() {
+    // 高 32 位是格子的 Z 序，低 32 位是格子下标
+    m_cellKeys.resize(m_touched.size());
+    for (std::size_t i = 0; i < m_touched.size(); ++i) {
+        std::int32_t index = m_touched[i];
+        m_cellKeys[i] = (static_cast<std::uint64_t>(MortonOrder::key(index / m_cols, index % m_cols)) << 32) |
+                        static_cast<std::uint32_t>(index);
+    }
+
+    // 不同格子的 Z 序互不相同，只按高 32 位排就够了
+    // 用基数排序 (每趟 8 位)，趟数看地图尺寸：Z 序在行、列上都单调，最大值就是右下角的格子
+    // 633x633 的图只有 20 位，3 趟；比 std::sort 快一个数量级，每帧都排也不显眼
+    const std::uint32_t maxKey = MortonOrder::key(m_rows - 1, m_cols - 1);
+    m_keyScratch.resize(m_cellKeys.size());
+    for (int shift = 32; shift < 64 && (maxKey >> (shift - 32)) != 0; shift += 8) {
+        std::uint32_t offsets[257] = {};
+        for (std::uint64_t key : m_cellKeys) {
+            ++offsets[((key >> shift) & 0xFF) + 1];
+        }
+        for (int d = 0; d < 256; ++d) {
+            offsets[d + 1] += offsets[d];
+        }
+        for (std::uint64_t key : m_cellKeys) {
+            m_keyScratch[offsets[(key >> shift) & 0xFF]++] = key;
+        }
+        m_cellKeys.swap(m_keyScratch);
+    }
+
+    // 按链表顺序把每格的条目搬成连续一段，next 指向紧挨着的下一个
+    m_sorted.resize(m_entries.size());
+    std::int32_t out = 0;
+    for (std::uint64_t key : m_cellKeys) {
+        std::int32_t index = static_cast<std::int32_t>(static_cast<std::uint32_t>(key));
+        std::int32_t i = m_heads[index];
+        m_heads[index] = out;
+        for (; i >= 0; i = m_entries[i].next) {
+            m_sorted[out] = m_entries[i];
+            m_sorted[out].next = out + 1;
+            ++out;
+        }
+        m_sorted[out - 1].next = -1;
+    }
+    m_entries.swap(m_sorted);
+}
+
+void SpatialGrid::addWatch(int team, int r0, int c0, int r1, int c1, int delta) {
+    for (int r = r0; r <= r1; ++r) {
+        std::uint32_t* row = m_watch.data() + (static_cast<std::size_t>(r) * m_blockCols) * 2 + team;
+        for (int c = c0; c <= c1; ++c) {
+            // 登记和撤销必须成对，减到负数说明有人重复撤销
+            assert(delta >= 0 || row[c * 2] >= static_cast<std::uint32_t>(-delta));
+            row[c * 2] += static_cast<std::uint32_t>(delta);
+        }
+    }
+}
+
+void SpatialGrid::clearAlarms() {
+    for (std::int32_t slot : m_alarms) {
+        m_alarmed[slot] = 0;
+    }
+    m_alarms.clear();
+}
@@ -0,0 +1,95 @@
+#include "TileMap.h"
+#include <iostream>
+
+TileMap::TileMap() : m_rows(0), m_cols(0), m_wordsPerRow(0), m_weightedCells(0) {}
+
+bool TileMap::create(int rows, int cols, TileType fill) {
+    if (rows <= 0 || cols <= 0 || rows > MAX_DIM || cols > MAX_DIM) {
+        std::cerr << "[TileMap] Invalid map size " << rows << "x" << cols
+                  << " (max " << MAX_DIM << "x" << MAX_DIM << ")" << std::endl;
+        return false;
+    }
+    m_rows = rows;
+    m_cols = cols;
+
+    std::size_t count = static_cast<std::size_t>(rows) * cols;
+    m_tiles.assign(count, fill);
+    m_costs.assign(count, TILE_INFO[fill].cost);
+    m_weightedCells = TILE_INFO[fill].cost > 1 ? static_cast<int>(count) : 0;
+
+    // 位图先全部清零 (哨兵)，可通行的地形再逐行把 [1, cols] 位置 1
+    m_wordsPerRow = (cols + 2 + 63) / 64;
+    m_passable.assign(static_cast<std::size_t>(rows + 2) * m_wordsPerRow, 0ull);
+    m_weighted.assign(m_passable.size(), 0ull);
+    if (isPassableType(fill)) {
+        bool weighted = TILE_INFO[fill].cost > 1;
+        for (int r = 0; r < rows; ++r) {
+            for (int c = 0; c < cols; ++c) {
+                setPassableBit(r, c, true);
+                if (weighted) setBit(m_weighted, m_wordsPerRow, r, c, true);
+            }
+        }
+    }
+    return true;
+}
+
+void TileMap::setCongestion(int r, int c, int penalty) {
+    int index = r * m_cols + c;
+    const TileInfo& info = TILE_INFO[m_tiles[index]];
+    if (!info.passable) return;
+    int cost = info.cost + (penalty > 0 ? penalty : 0);
+    setCost(index, cost < MAX_STEP_COST ? cost : MAX_STEP_COST);
+}
+
+void TileMap::setCost(int index, int cost) {
+    // 维护加权格计数和位图，isUniformCost() 才能 O(1) 回答
+    if (m_costs[index] > 1) m_weightedCells--;
+    m_costs[index] = static_cast<std::uint8_t>(cost);
+    if (cost > 1) m_weightedCells++;
+    setBit(m_weighted, m_wordsPerRow, index / m_cols, index % m_cols, cost > 1);
+}
+
+void TileMap::setBit(std::vector<std::uint64_t>& bits, int wordsPerRow, int r, int c, bool value) {
+    unsigned bit = static_cast<unsigned>(c + 1);
+    std::uint64_t& word = bits[(r + 1) * wordsPerRow + (bit >> 6)];
+    std::uint64_t mask = 1ull << (bit & 63);
+    if (value) word |= mask;
+    else       word &= ~mask;
+}
+
+void TileMap::set(int r, int c, TileType type) {
+    int index = r * m_cols + c;
+    m_tiles[index] = type;
+    setCost(index, TILE_INFO[type].cost); // 改地形同时清掉拥堵惩罚
+    setPassableBit(r, c, isPassableType(type));
+}
+
+bool TileMap::assign(int rows, int cols, const std::uint8_t* tiles) {
+    // 先按不可通行创建 (位图全 0)，再按地形逐行置位
+    if (!create(rows, cols, MOUNTAIN)) return false;
+
+    std::size_t count = static_cast<std::size_t>(rows) * cols;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (tiles[i] >= TILE_TYPE_COUNT) {
+            std::cerr << "[TileMap] Invalid tile value " << int(tiles[i]) << " at index " << i << std::endl;
+            return false;
+        }
+    }
+    m_tiles.assign(tiles, tiles + count);
+
+    // 顺序扫描地形生成位图和代价
+    m_weightedCells = 0;
+    for (int r = 0; r < rows; ++r) {
+        std::size_t base = static_cast<std::size_t>(r) * cols;
+        for (int c = 0; c < cols; ++c) {
+            const TileInfo& info = TILE_INFO[m_tiles[base + c]];
+            m_costs[base + c] = info.cost;
+            if (info.cost > 1) {
+                m_weightedCells++;
+                setBit(m_weighted, m_wordsPerRow, r, c, true);
+            }
+            if (info.passable) setPassableBit(r, c, true);
+        }
+    }
+    return true;
+}
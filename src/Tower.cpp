@@ -1,5 +1,5 @@
 #include "Tower.h"
-#include "Projectile.h"
+#include "ProjectileSystem.h"
 #include "ResourceManager.h"
 #include <iostream>
 #include <cmath>
@@ -73,13 +73,13 @@ Tower::Tower(float x, float y, Team team, TowerType type)
     m_sprite.setColor(sf::Color::Transparent); 
 }
 
-void Tower::update(float dt, const std::vector<std::vector<Unit*>>& spatialGrid, std::vector<Projectile*>& activeProjectiles, ObjectPool<Projectile>& projectilePool, const std::vector<std::vector<int>>& mapData) {
+void Tower::update(float dt, const SpatialGrid& spatialGrid, ProjectileSystem& projectiles, DamageBuffer& /*damage*/, const TileMap& /*map*/, PathScheduler& /*pathScheduler*/) {
     // 逻辑：如果当前颜色不是完全透明，说明刚刚受击变成了红色。
     // 我们让它迅速淡出变回透明，而不是变成有颜色的状态。
     sf::Color c = getSprite().getColor();
     
     if (c.a > 0) { // 如果不透明
-        // 1. 如果是 Unit::takeDamage 设置的纯红 (255, 0, 0, 255)，立即改为半透明红，作为受击反馈
+        // 1. 如果是 Unit::applyDamage 设置的纯红 (255, 0, 0, 255)，立即改为半透明红，作为受击反馈
         if (c.r == 255 && c.g == 0 && c.b == 0 && c.a == 255) {
             c.a = 100; // 设置为半透明，稍微闪一下
             getSprite().setColor(c);
@@ -99,18 +99,18 @@ void Tower::update(float dt, const std::vector<std::vector<Unit*>>& spatialGrid,
     // 1. 攻击冷却
     if (m_attackTimer > 0) m_attackTimer -= dt;
 
-    // 2. 寻找敌人
-    Unit* target = findClosestEnemy(spatialGrid);
+    // 2. 寻找敌人 (休眠中说明附近没有敌人，不用找)
+    Unit* target = isAsleep() ? nullptr : findClosestEnemy(spatialGrid);
+    if (!target && !isAsleep()) m_wantsSleep = true;
     
     // 3. 攻击逻辑
     if (target) {
         sf::Vector2f diff = target->getPosition() - getPosition();
-        float dist = std::sqrt(diff.x * diff.x + diff.y * diff.y);
 
-        if (dist <= m_range) {
+        if (diff.x * diff.x + diff.y * diff.y <= m_range * m_range) {
             // 在射程内，且冷却完毕
             if (m_attackTimer <= 0) {
-                shoot(target, activeProjectiles, projectilePool);
+                shoot(target, projectiles);
                 m_attackTimer = m_attackInterval;
             }
         }
@@ -120,10 +120,9 @@ void Tower::update(float dt, const std::vector<std::vector<Unit*>>& spatialGrid,
     updateUI();
 }
 
-void Tower::shoot(Unit* target, std::vector<Projectile*>& activeProjectiles, ObjectPool<Projectile>& projectilePool) {
+void Tower::shoot(Unit* target, ProjectileSystem& projectiles) {
     // 发射子弹
     // 为了视觉效果，让子弹从塔的“顶部”飞出 (y - 30 像素)
     // 这样看起来更有立体感
-    Projectile* p = projectilePool.acquire(getPosition().x, getPosition().y - 30.f, target, m_atk);
-    activeProjectiles.push_back(p);
+    projectiles.spawn(sf::Vector2f(getPosition().x, getPosition().y - 30.f), target, m_atk);
 }
\ No newline at end of file
@@ -0,0 +1,93 @@
+#include "TowerRegistry.h"
+#include "Tower.h"
+#include <algorithm>
+
+void TowerRegistry::attach(EventBus& bus) {
+    bus.subscribe(GameEventType::UNIT_SPAWNED, [this](const GameEvent& e) { onSpawned(e.unit); });
+    // 事件类型已经保证 unit 是塔，不需要 RTTI
+    bus.subscribe(GameEventType::TOWER_DESTROYED, [this](const GameEvent& e) { onTowerDestroyed(static_cast<Tower*>(e.unit)); });
+    bus.subscribe(GameEventType::UNIT_DIED, [this](const GameEvent& e) { onUnitDied(e.unit); });
+}
+
+Tower* TowerRegistry::king(int team) const {
+    for (const auto& entry : m_entries[team]) {
+        if (entry.tower->isKing()) return entry.tower;
+    }
+    return nullptr;
+}
+
+void TowerRegistry::onSpawned(Unit* unit) {
+    int team = unit->getTeam();
+    if (unit->isStructure()) {
+        m_entries[team].push_back(Entry{ static_cast<Tower*>(unit), {} });
+        return;
+    }
+
+    // 战略目标就是出生点：地图没配进攻路线，原地待命
+    sf::Vector2f target = unit->getStrategicTarget();
+    if (target == unit->getPosition()) return;
+
+    // 路线终点上的塔还在就订阅它；已经被拆了就直接去国王塔
+    int enemy = 1 - team;
+    Tower* tower = towerAt(enemy, static_cast<int>(target.y) / Game::TILE_SIZE, static_cast<int>(target.x) / Game::TILE_SIZE);
+    assign(unit, tower ? tower : king(enemy));
+}
+
+void TowerRegistry::onTowerDestroyed(Tower* tower) {
+    int team = tower->getTeam();
+    auto& entries = m_entries[team];
+    auto it = std::find_if(entries.begin(), entries.end(), [tower](const Entry& e) { return e.tower == tower; });
+    if (it == entries.end()) return;
+
+    // 先注销这座塔，再把订阅者转给国王塔 (国王塔本身倒下时游戏已经结束，订阅者原地待命)
+    std::vector<Unit*> subscribers = std::move(it->subscribers);
+    entries.erase(it);
+
+    Tower* fallback = king(team);
+    for (Unit* unit : subscribers) {
+        assign(unit, fallback);
+    }
+}
+
+void TowerRegistry::onUnitDied(Unit* unit) {
+    unsubscribe(unit);
+}
+
+TowerRegistry::Entry* TowerRegistry::find(Tower* tower) {
+    for (auto& entry : m_entries[tower->getTeam()]) {
+        if (entry.tower == tower) return &entry;
+    }
+    return nullptr;
+}
+
+Tower* TowerRegistry::towerAt(int team, int row, int col) const {
+    for (const auto& entry : m_entries[team]) {
+        sf::Vector2f pos = entry.tower->getPosition();
+        if (static_cast<int>(pos.y) / Game::TILE_SIZE == row && static_cast<int>(pos.x) / Game::TILE_SIZE == col) {
+            return entry.tower;
+        }
+    }
+    return nullptr;
+}
+
+void TowerRegistry::assign(Unit* unit, Tower* tower) {
+    unsubscribe(unit);
+    if (!tower) return;
+    find(tower)->subscribers.push_back(unit);
+    unit->retarget(tower->getPosition(), tower);
+}
+
+void TowerRegistry::unsubscribe(Unit* unit) {
+    Tower* tower = unit->getStrategicTower();
+    if (!tower) return;
+    unit->setStrategicTower(nullptr);
+
+    Entry* entry = find(tower);
+    if (!entry) return;
+    auto& subs = entry->subscribers;
+    auto it = std::find(subs.begin(), subs.end(), unit);
+    if (it != subs.end()) {
+        *it = subs.back(); // 顺序无关，交换删除
+        subs.pop_back();
+    }
+}
@@ -2,18 +2,32 @@
 #include "Tower.h"
 #include "Pathfinder.h" 
 #include "ResourceManager.h"
+#include "AudioMixer.h"
+#include "DistanceKernels.h"
+#include "DamageBuffer.h"
 #include <cmath> 
+#include <algorithm>
 #include <iostream>
 
 // ======================= 基类 Unit =======================
+float Unit::s_thinkScale = 1.0f;
+unsigned Unit::s_thinkPhase = 0;
+
 Unit::Unit(float x, float y, Team team) 
-    : m_team(team), m_attackTimer(0.f), m_facingDir(0.f, 1.f), // 默认朝下
-        m_hasCrown(false), m_barMaxWidth(40.f), m_lockedEnemy(nullptr),
-        m_repathTimer(0.f) // 初始化计时器
+    : m_team(team), m_strategicTower(nullptr),
+        m_thinkInterval(4), m_thinkCountdown(0), // 刚出生的第一帧就思考
+        m_sleepSlot(-1), m_wantsSleep(false),
+        m_attackTimer(0.f),
+        m_repathTimer(0.f), // 初始化计时器
+        m_facingDir(0.f, 1.f), // 默认朝下
+        m_pathPending(false), m_pathRetryTimer(0.f),
+        m_hitSfx(SoundId::COUNT), // 默认没有音效 (例如塔)
+        m_hasCrown(false), m_barMaxWidth(40.f)
 {
     // 默认属性 (作为一个兜底，子类会覆盖它)
     m_hp = 100.f;
     m_maxHp = 100.f;
+    m_armor = 0.f;
     m_atk = 10.f;
     m_speed = 60.f; // 每秒移动 60 像素
     m_range = 60.f; 
@@ -27,27 +41,73 @@ Unit::Unit(float x, float y, Team team)
     initUI(false); 
 }
 
+bool Unit::tickThink() {
+    if (--m_thinkCountdown > 0) return false;
+    int interval = std::max(1, static_cast<int>(m_thinkInterval * s_thinkScale + 0.5f));
+    // 第一次思考后按全局计数错开相位，同一帧出生的一批单位不会一直挤在同一帧
+    if (m_thinkCountdown == -1) {
+        m_thinkCountdown = interval + static_cast<int>(s_thinkPhase++ % interval);
+    } else {
+        m_thinkCountdown = interval;
+    }
+    return true;
+}
+
 void Unit::setStrategicTarget(float x, float y) {
     m_strategicTarget = sf::Vector2f(x, y);
     // 初始设置时，清空路径，以便下次 update 自动计算
-    m_pathQueue.clear();
+    resetPath();
+}
+
+void Unit::retarget(sf::Vector2f target, Tower* tower) {
+    m_strategicTower = tower;
+    if (target == m_strategicTarget) return;
+    m_strategicTarget = target;
+    resetPath(); // 目标变了，重算路径
+}
+
+void Unit::pathfindToStrategic(PathScheduler& pathScheduler) {
+    requestPath(pathScheduler, m_strategicTarget, PathUrgency::STRATEGIC);
 }
 
-void Unit::pathfindToStrategic(const std::vector<std::vector<int>>& mapData) {
+void Unit::requestPath(PathScheduler& pathScheduler, sf::Vector2f target, PathUrgency urgency) {
     sf::Vector2f startPos = getPosition();
-    int startCol = static_cast<int>(startPos.x) / Game::TILE_SIZE;
-    int startRow = static_cast<int>(startPos.y) / Game::TILE_SIZE;
-    
-    int endCol = static_cast<int>(m_strategicTarget.x) / Game::TILE_SIZE;
-    int endRow = static_cast<int>(m_strategicTarget.y) / Game::TILE_SIZE;
+    sf::Vector2i startNode(static_cast<int>(startPos.x) / Game::TILE_SIZE, static_cast<int>(startPos.y) / Game::TILE_SIZE);
+    sf::Vector2i endNode(static_cast<int>(target.x) / Game::TILE_SIZE, static_cast<int>(target.y) / Game::TILE_SIZE);
+
+    m_pathGoal = target;
+    if (startNode == endNode) {
+        // 已经在目标格里了，不用寻路，直接走过去
+        m_pathQueue.clear();
+        m_pathQueue.push_back(target);
+        m_pathPending = false;
+        return;
+    }
+    pathScheduler.request(this, startNode, endNode, urgency);
+    m_pathPending = true;
+}
+
+void Unit::onPathReady(const std::vector<sf::Vector2i>& path, bool found) {
+    if (!m_pathPending) return; // 请求之后目标又变了
+    m_pathPending = false;
+    if (!found) {
+        m_pathRetryTimer = 1.0f;
+        return;
+    }
 
-    std::vector<sf::Vector2i> gridPath = Pathfinder::findPath(mapData, {startCol, startRow}, {endCol, endRow});
+    // 将 网格路径 转换回 像素中心点，存入队列
     m_pathQueue.clear();
-    for (const auto& node : gridPath) {
+    for (const auto& node : path) {
+        // 目标点应该是格子的中心： col * 40 + 20
         m_pathQueue.push_back(sf::Vector2f(node.x * Game::TILE_SIZE + Game::TILE_SIZE / 2.0f, node.y * Game::TILE_SIZE + Game::TILE_SIZE / 2.0f));
     }
 }
 
+void Unit::resetPath() {
+    m_pathQueue.clear();
+    m_pathPending = false;
+}
+
 void Unit::initUI(bool hasCrown, float barWidth, float barHeight, float yOffset) {
     m_hasCrown = hasCrown;
     m_barMaxWidth = barWidth;
@@ -70,7 +130,7 @@ void Unit::initUI(bool hasCrown, float barWidth, float barHeight, float yOffset)
 
     // 3. 设置皇冠图标
     if (m_hasCrown) {
-            m_crownSprite.setTexture(ResourceManager::getInstance().getTexture("ui_crown"));
+            m_crownSprite.setTexture(ResourceManager::getInstance().getTexture(TextureId::UI_CROWN));
             // 假设皇冠放在血条左侧，稍微偏出一点
             sf::FloatRect bounds = m_crownSprite.getLocalBounds();
             m_crownSprite.setOrigin(bounds.width / 2.f, bounds.height / 2.f); // 底部中心
@@ -107,6 +167,10 @@ void Unit::render(sf::RenderWindow& window) {
     Movable::render(window);
 
     // 2. 绘制 UI (在单位上方)
+    renderHud(window);
+}
+
+void Unit::renderHud(sf::RenderWindow& window) {
     window.draw(m_hpBarBg);
     window.draw(m_hpBarFg);
     if (m_hasCrown) {
@@ -115,31 +179,31 @@ void Unit::render(sf::RenderWindow& window) {
 }
 
 // 初始化音效并播放部署声音
-void Unit::initSounds(const std::string& deployKey, const std::string& hitKey) {
-    try {
-        // 从 ResourceManager 获取 SoundBuffer
-        m_deploySound.setBuffer(ResourceManager::getInstance().getSoundBuffer(deployKey));
-        m_hitSound.setBuffer(ResourceManager::getInstance().getSoundBuffer(hitKey));
-        
-        // 立即播放部署音效
-        m_deploySound.play();
-    } catch (const std::exception& e) {
-        std::cerr << "[Unit] Error loading sounds: " << e.what() << std::endl;
-    }
+void Unit::initSounds(SoundId deployKey, SoundId hitKey) {
+    m_hitSfx = hitKey;
+
+    // 部署音效：玩家操作的直接反馈，优先级高
+    AudioMixer::getInstance().post(deployKey, getPosition(), SoundPriority::HIGH);
 }
 
-// 扣血逻辑
-void Unit::takeDamage(float damage) {
-    m_hp -= damage;
+// 护甲：每次命中减去固定值，但最多减免 90% (再硬也不能免疫)
+float Unit::mitigate(float amount) const {
+    return std::max(amount - m_armor, amount * 0.1f);
+}
+
+// 扣血逻辑 (一帧只调用一次)
+void Unit::applyDamage(float total) {
+    m_hp -= total;
     // 简单的受击反馈：变红一下
     getSprite().setColor(sf::Color::Red);
 }
 
 // 空间划分寻敌算法
 // 复杂度：O(K)，K 为周围格子内的单位数，远小于 O(N)
-Unit* Unit::findClosestEnemy(const std::vector<std::vector<Unit*>>& spatialGrid) {
-    Unit* closest = nullptr;
-    float minDist = 99999.f;
+// 先把敌方候选收集成 SoA，再批量比较平方距离 (一次 8 个，不开方)
+Unit* Unit::findClosestEnemy(const SpatialGrid& spatialGrid) {
+    thread_local CandidateBlock candidates;
+    candidates.clear();
 
     // 1. 计算当前所在的网格坐标
     sf::Vector2f myPos = getPosition();
@@ -150,48 +214,39 @@ Unit* Unit::findClosestEnemy(const std::vector<std::vector<Unit*>>& spatialGrid)
     // 索敌范围 / 格子大小，向上取整
     int searchRadius = static_cast<int>(std::ceil(m_aggroRange / Game::TILE_SIZE));
 
-    // 3. 遍历周围的格子 (Square Loop)
+    // 3. 遍历周围的格子 (Square Loop)，收集候选
     for (int r = centerRow - searchRadius; r <= centerRow + searchRadius; ++r) {
         for (int c = centerCol - searchRadius; c <= centerCol + searchRadius; ++c) {
             
             // 越界检查
-            if (r >= 0 && r < Game::ROWS && c >= 0 && c < Game::COLS) {
-                int index = r * Game::COLS + c;
-                
+            if (spatialGrid.inBounds(r, c)) {
                 // 遍历该格子内的所有单位
-                const auto& cellUnits = spatialGrid[index];
-                for (auto other : cellUnits) {
-                    if (!other) continue;
-                    if (other == this) continue;
-                    if (other->isDead()) continue;
-                    if (other->getTeam() == this->getTeam()) continue; 
-
-                    sf::Vector2f diff = other->getPosition() - myPos;
-                    float dist = std::sqrt(diff.x * diff.x + diff.y * diff.y);
-
-                    if (dist > m_aggroRange) continue;
-
-                    if (dist < minDist) {
-                        minDist = dist;
-                        closest = other;
-                    }
+                // 只看条目里的快照，不碰单位对象；网格在清理尸体后才重建，帧内又没人直接扣血，所以里面都是活的
+                for (const SpatialGrid::Entry& other : spatialGrid.cell(r, c)) {
+                    if (other.unit == this) continue;
+                    if (other.team == this->getTeam()) continue; 
+
+                    candidates.push(other.unit, sf::Vector2f(other.x, other.y));
                 }
             }
         }
     }
-    return closest;
+
+    // 4. 警戒范围内最近的一个
+    return candidates.nearest(myPos, m_aggroRange);
 }
 
 // 默认攻击逻辑：单体伤害
-void Unit::performAttack(Unit* target, const std::vector<std::vector<Unit*>>& spatialGrid) {
+void Unit::performAttack(Unit* target, const SpatialGrid& spatialGrid, ProjectileSystem& projectiles, DamageBuffer& damage) {
     if (target) {
-        target->takeDamage(m_atk);
-        m_hitSound.play();
+        damage.submit(target, m_atk);
+        // 只投递事件，同一帧的相同音效会被混音器合并
+        AudioMixer::getInstance().post(m_hitSfx, getPosition(), SoundPriority::LOW);
     }
 }
 
 // 【核心 AI 逻辑】
-void Unit::update(float dt,const std::vector<std::vector<Unit*>>& spatialGrid, std::vector<Projectile*>& activeProjectiles, ObjectPool<Projectile>& projectilePool, const std::vector<std::vector<int>>& mapData) {
+void Unit::update(float dt,const SpatialGrid& spatialGrid, ProjectileSystem& projectiles, DamageBuffer& damage, const TileMap& map, PathScheduler& pathScheduler) {
     if (getSprite().getColor() != sf::Color::White) {
         // 简单的颜色恢复渐变效果
         sf::Color c = getSprite().getColor();
@@ -211,41 +266,51 @@ void Unit::update(float dt,const std::vector<std::vector<Unit*>>& spatialGrid, s
 
     // 0. 更新攻击计时器
     if (m_attackTimer > 0) m_attackTimer -= dt;
+    if (m_pathRetryTimer > 0) m_pathRetryTimer -= dt;
+    m_velocity = sf::Vector2f(0.f, 0.f); // 本帧走了 followPath 才会写入
 
     // ================= AI 决策树 =================
 
+    // 本帧是否轮到思考 (索敌 / 验证锁定 / 定时换路)
+    bool think = tickThink();
+
     // 1. 验证当前锁定的敌人是否依然有效 (存活且在警戒范围内)
-    if (m_lockedEnemy) {
-        if (m_lockedEnemy->isDead()) {
-            m_lockedEnemy = nullptr;
-        } else {
-            sf::Vector2f diff = m_lockedEnemy->getPosition() - getPosition();
-            float dist = std::sqrt(diff.x*diff.x + diff.y*diff.y);
-            if (dist > m_aggroRange * 1.5f) { // 追太远就放弃 (防抖动，给个1.5倍缓冲)
-                m_lockedEnemy = nullptr;
+    // 死亡检查每帧都做 (已被删除的目标解析不出来)，距离检查只在思考帧做
+    Unit* enemy = damage.units().get(m_lockedEnemy);
+    if (enemy) {
+        if (enemy->isDead()) {
+            enemy = nullptr;
+        } else if (think) {
+            sf::Vector2f diff = enemy->getPosition() - getPosition();
+            float giveUp = m_aggroRange * 1.5f;
+            if (diff.x*diff.x + diff.y*diff.y > giveUp * giveUp) { // 追太远就放弃 (防抖动，给个1.5倍缓冲)
+                enemy = nullptr;
             }
         }
     }
 
     // 2. 如果没有锁定敌人，尝试索敌 (Giant 会忽略这一步因为 findClosestEnemy 返回 nullptr)
-    if (!m_lockedEnemy) {
+    // 休眠中说明附近没有敌人，跳过扫描；有敌人靠近时调度器会先把它叫醒
+    if (!enemy && !isAsleep() && think) {
         Unit* potential = findClosestEnemy(spatialGrid);
         if (potential) {
             sf::Vector2f diff = potential->getPosition() - getPosition();
-            float dist = std::sqrt(diff.x*diff.x + diff.y*diff.y);
-            if (dist <= m_aggroRange) {
-                m_lockedEnemy = potential;
+            if (diff.x*diff.x + diff.y*diff.y <= m_aggroRange * m_aggroRange) {
+                enemy = potential;
                 // 一旦发现敌人，清空推塔路径，准备战斗/追击
-                m_pathQueue.clear(); 
+                resetPath();
             }
         }
+        // 警戒范围内没有敌人：请求休眠，直到有敌人靠近
+        if (!enemy) m_wantsSleep = true;
     }
+    m_lockedEnemy = enemy ? enemy->getHandle() : UnitHandle{};
 
     AnimState currentState = AnimState::WALK;
 
     // 3. 战斗逻辑 (针对 Locked Enemy)
-    if (m_lockedEnemy) {
-        sf::Vector2f enemyPos = m_lockedEnemy->getPosition();
+    if (enemy) {
+        sf::Vector2f enemyPos = enemy->getPosition();
         sf::Vector2f diff = enemyPos - getPosition();
         float dist = std::sqrt(diff.x*diff.x + diff.y*diff.y);
         m_facingDir = diff; // 面向敌人
@@ -254,7 +319,7 @@ void Unit::update(float dt,const std::vector<std::vector<Unit*>>& spatialGrid, s
             // 射程内 -> 攻击
             currentState = AnimState::ATTACK;
             if (m_attackTimer <= 0) {
-                performAttack(m_lockedEnemy, spatialGrid);
+                performAttack(enemy, spatialGrid, projectiles, damage);
                 m_attackTimer = m_attackInterval; 
             }
         } else {
@@ -262,13 +327,14 @@ void Unit::update(float dt,const std::vector<std::vector<Unit*>>& spatialGrid, s
             m_repathTimer -= dt;
             
             // 如果路径走完了(但还没追上)，或者过了0.5秒(敌人位置变了)，就重新寻路
-            if (m_pathQueue.empty() || m_repathTimer <= 0.f) {
-                setTarget(enemyPos.x, enemyPos.y, mapData);
+            // 手上还有路时只是换条新路，排在没路可走的请求后面；换路是决策，只在思考帧做
+            if ((m_pathQueue.empty() && !m_pathPending) || (think && m_repathTimer <= 0.f)) {
+                setTarget(enemyPos.x, enemyPos.y, pathScheduler, m_pathQueue.empty() ? PathUrgency::COMBAT : PathUrgency::REPLAN);
                 m_repathTimer = 0.5f; // 重置计时器
             }
             
             // 沿路径移动
-            followPath(dt);
+            followPath(dt, map);
 
             // 更新朝向
             if (!m_pathQueue.empty()) {
@@ -281,41 +347,12 @@ void Unit::update(float dt,const std::vector<std::vector<Unit*>>& spatialGrid, s
     } 
     // 4. 推塔逻辑 (无敌人干扰)
     else {
-        // (A) 检查当前战略目标（塔）是否还活着
-        bool isStrategicAlive = false;
-        // 简单判断：目标位置附近是否有活着的 Tower
-        int tCol = static_cast<int>(m_strategicTarget.x) / Game::TILE_SIZE;
-        int tRow = static_cast<int>(m_strategicTarget.y) / Game::TILE_SIZE;
-        
-        // 检查目标格子里的单位
-        if (tCol >= 0 && tCol < Game::COLS && tRow >= 0 && tRow < Game::ROWS) {
-            int idx = tRow * Game::COLS + tCol;
-            for (auto u : spatialGrid[idx]) {
-                if (dynamic_cast<Tower*>(u) && u->getTeam() != m_team && !u->isDead()) {
-                    isStrategicAlive = true;
-                    break;
-                }
-            }
-        }
-
-        // (B) 如果目标塔挂了，切换到敌方国王塔
-        if (!isStrategicAlive) {
-            float kingX = 10 * Game::TILE_SIZE + 20;
-            float kingY = (m_team == TEAM_A) ? (16 * Game::TILE_SIZE + 20) : (2 * Game::TILE_SIZE + 20);
-            
-            // 如果已经是国王塔了就不切了，避免死循环
-            // 简单距离判断
-            float distToKing = std::abs(m_strategicTarget.y - kingY);
-            if (distToKing > 50.0f) { // 说明当前不是国王塔
-                m_strategicTarget = sf::Vector2f(kingX, kingY);
-                m_pathQueue.clear(); // 目标变了，重算路径
-            }
-        }
-
-        // (C) 移动向战略目标
-        // 如果没有路径，计算路径
-        if (m_pathQueue.empty()) {
-            pathfindToStrategic(mapData);
+        // (A) 目标塔被摧毁时，TowerRegistry 会通过 retarget 把单位转到敌方国王塔，
+        //     这里不再每帧检查目标塔是否还活着
+        // (B) 移动向战略目标
+        // 如果没有路径，请求路径 (结果回来之前先直接朝目标走)
+        if (m_pathQueue.empty() && !m_pathPending && m_pathRetryTimer <= 0.f) {
+            pathfindToStrategic(pathScheduler);
         }
         
         // 沿路径移动 (最后一段距离如果是攻击范围，可以提前停，但为了简单我们让它走到面前)
@@ -331,7 +368,7 @@ void Unit::update(float dt,const std::vector<std::vector<Unit*>>& spatialGrid, s
         // "findClosestEnemy" 应该优先返回兵。
         // 让我们修正一下 findClosestEnemy 的逻辑。
         
-        followPath(dt);
+        followPath(dt, map);
         
         // 如果正在移动，更新朝向
         if (!m_pathQueue.empty()) {
@@ -342,45 +379,45 @@ void Unit::update(float dt,const std::vector<std::vector<Unit*>>& spatialGrid, s
         }
     }
 
-    updateAnimation(dt, m_facingDir, currentState);
+    // 动画帧由渲染线程推进，这里只记录状态和朝向
+    setAnimState(currentState, m_facingDir);
     updateUI();
 }
 
 // 计算路径
-void Unit::setTarget(float tx, float ty, const std::vector<std::vector<int>>& mapData) {
-    sf::Vector2f startPos = getPosition(); // 使用 Movable 的 getPosition
-    
-    int startCol = static_cast<int>(startPos.x) / Game::TILE_SIZE;
-    int startRow = static_cast<int>(startPos.y) / Game::TILE_SIZE;
-    
-    int endCol = static_cast<int>(tx) / Game::TILE_SIZE;
-    int endRow = static_cast<int>(ty) / Game::TILE_SIZE;
-
-    sf::Vector2i startNode(startCol, startRow);
-    sf::Vector2i endNode(endCol, endRow);
-    
-    // 2. 调用 BFS 算法
-    std::vector<sf::Vector2i> gridPath = Pathfinder::findPath(mapData, startNode, endNode);
-
-    // 3. 将 网格路径 转换回 像素中心点，存入队列
-    m_pathQueue.clear();
-    for (const auto& node : gridPath) {
-        // 目标点应该是格子的中心： col * 40 + 20
-        float worldX = node.x * Game::TILE_SIZE + Game::TILE_SIZE / 2.0f;
-        float worldY = node.y * Game::TILE_SIZE + Game::TILE_SIZE / 2.0f;
-        m_pathQueue.push_back(sf::Vector2f(worldX, worldY));
-    }
+void Unit::setTarget(float tx, float ty, PathScheduler& pathScheduler, PathUrgency urgency) {
+    requestPath(pathScheduler, sf::Vector2f(tx, ty), urgency);
 }
 
-void Unit::followPath(float dt) {
-    if (m_pathQueue.empty()) return;
-    // 获取当前要去的下一个小目标点
-    sf::Vector2f target = m_pathQueue.front();
-    sf::Vector2f dir = target - getPosition();
+void Unit::followPath(float dt, const TileMap& map) {
+    bool steering = m_pathQueue.empty();
+    if (steering && !m_pathPending) return;
+
+    // 获取当前要去的下一个小目标点 (路径还在排队时就是请求的目标本身)
+    sf::Vector2f target = steering ? m_pathGoal : m_pathQueue.front();
+    sf::Vector2f pos = getPosition();
+    sf::Vector2f dir = target - pos;
     float dist = std::sqrt(dir.x * dir.x + dir.y * dir.y);
-    if (dist < 5.0f) { m_pathQueue.pop_front(); return; }
+    if (dist < 5.0f) {
+        if (!steering) m_pathQueue.pop_front();
+        return;
+    }
     sf::Vector2f normDir = dir / dist;
-    m_sprite.move(normDir * m_speed * dt);
+
+    // 泥地等慢速地形减速
+    float speed = m_speed;
+    int row = static_cast<int>(pos.y) / Game::TILE_SIZE;
+    int col = static_cast<int>(pos.x) / Game::TILE_SIZE;
+    if (map.inBounds(row, col)) speed *= TILE_INFO[map.at(row, col)].speedFactor;
+    sf::Vector2f step = normDir * speed * dt;
+
+    if (steering) {
+        // 直线走没有经过寻路检查，前方是河或山就停下等路径
+        sf::Vector2f next = pos + step;
+        if (!map.isPassable(static_cast<int>(next.y) / Game::TILE_SIZE, static_cast<int>(next.x) / Game::TILE_SIZE)) return;
+    }
+    m_sprite.move(step);
+    m_velocity = normDir * speed;
 }
 
 
@@ -388,12 +425,25 @@ void Unit::followPath(float dt) {
 
 Tank::Tank(float x, float y, Team team) : Unit(x, y, team) {
     m_hp = 300.f; m_maxHp = 300.f; m_atk = 20.f; m_speed = 30.f; 
+    m_armor = 2.f; // 肉盾自带一点护甲
+    m_thinkInterval = 6; // 走得慢，反应慢一点看不出来
 }
 Melee::Melee(float x, float y, Team team) : Unit(x, y, team) {
     m_hp = 150.f; m_maxHp = 150.f; m_atk = 15.f; m_speed = 60.f;
+    m_thinkInterval = 4;
 }
 Ranged::Ranged(float x, float y, Team team) : Unit(x, y, team) {
     m_hp = 60.f; m_maxHp = 60.f; m_atk = 10.f; m_speed = 70.f; m_range = 150.f;
+    m_thinkInterval = 3; // 远程单位要及时发现射程内的目标
+    m_projectileKind = ProjectileKind::ARROW;
+}
+
+// 远程攻击：按提前量射出子弹，命中时才扣血
+void Ranged::performAttack(Unit* target, const SpatialGrid& spatialGrid, ProjectileSystem& projectiles, DamageBuffer& damage) {
+    if (target) {
+        projectiles.spawn(getPosition(), target, m_atk, m_projectileKind);
+        AudioMixer::getInstance().post(m_hitSfx, getPosition(), SoundPriority::LOW);
+    }
 }
 
 // ======================= 具体兵种实现 =======================
@@ -403,21 +453,22 @@ Giant::Giant(float x, float y, Team team) : Tank(x, y, team) {
     m_hp = 600.f; m_maxHp = 600.f; m_atk = 30.f; m_speed = 25.f; // 极肉，慢
     
     // 配置动画参数
-    AnimInfo info;
-    info.frameWidth = 201.5; info.frameHeight = 206; 
-    info.walkFrames = 8;  info.attackFrames = 8;
-    info.walkDuration = 0.15f; info.attackDuration = 0.15f;
-
-    initSprite(ResourceManager::getInstance().getTexture("unit_giant"), info);
+    // 帧表每个兵种只构建一次，所有同类单位共享
+    static const AnimTable table = [] {
+        AnimInfo info;
+        info.frameWidth = 201.5; info.frameHeight = 206; 
+        info.walkFrames = 8;  info.attackFrames = 8;
+        info.walkDuration = 0.15f; info.attackDuration = 0.15f;
+        // 映射: 上5行攻击(0-4), 下5行行走(5-9)
+        // 请根据游戏内的实际朝向调整这些数字的顺序
+        // 顺序: Up, UpRight, Right, DownRight, Down (先行走行，后攻击行)
+        return AnimTable::build(info, {9, 7, 6, 8, 5}, {1, 4, 3, 0, 2});
+    }();
+
+    initSprite(ResourceManager::getInstance().getTexture(TextureId::UNIT_GIANT), table);
     setScale(0.3f, 0.3f); // 巨人要大
 
-    // 映射: 上5行攻击(0-4), 下5行行走(5-9)
-    // 请根据游戏内的实际朝向调整这些数字的顺序
-    // 顺序: Up, UpRight, Right, DownRight, Down
-    setAttackRows(1, 4, 3, 0, 2);
-    setWalkRows(9, 7, 6, 8, 5);
-
-    initSounds("sfx_deploy_giant", "sfx_hit_giant");
+    initSounds(SoundId::DEPLOY_GIANT, SoundId::HIT_GIANT);
 
     // UI: 无皇冠，宽条，位置较高
     initUI(false, 50.f, 6.f, -45.f);
@@ -427,9 +478,9 @@ Giant::Giant(float x, float y, Team team) : Tank(x, y, team) {
 // 这样他就会一直执行 moveToTarget 走向敌方基地。
 // Giant 只看塔
 // 【修改】巨人只打建筑，使用空间网格加速
-Unit* Giant::findClosestEnemy(const std::vector<std::vector<Unit*>>& spatialGrid) {
-    Unit* closest = nullptr;
-    float minDist = 99999.f;
+Unit* Giant::findClosestEnemy(const SpatialGrid& spatialGrid) {
+    thread_local CandidateBlock candidates;
+    candidates.clear();
 
     sf::Vector2f myPos = getPosition();
     int centerCol = static_cast<int>(myPos.x) / Game::TILE_SIZE;
@@ -440,41 +491,39 @@ Unit* Giant::findClosestEnemy(const std::vector<std::vector<Unit*>>& spatialGrid
 
     for (int r = centerRow - searchRadius; r <= centerRow + searchRadius; ++r) {
         for (int c = centerCol - searchRadius; c <= centerCol + searchRadius; ++c) {
-            if (r >= 0 && r < Game::ROWS && c >= 0 && c < Game::COLS) {
-                int index = r * Game::COLS + c;
-                for (auto other : spatialGrid[index]) {
-                    if (!other || other == this || other->isDead() || other->getTeam() == this->getTeam()) continue;
+            if (spatialGrid.inBounds(r, c)) {
+                for (const SpatialGrid::Entry& other : spatialGrid.cell(r, c)) {
+                    if (other.unit == this || other.team == this->getTeam()) continue;
                     
-                    if (!dynamic_cast<Tower*>(other)) continue;
+                    if (!other.structure) continue;
 
-                    sf::Vector2f diff = other->getPosition() - this->getPosition();
-                    float dist = std::sqrt(diff.x * diff.x + diff.y * diff.y);
-                    
-                    if (dist < minDist) { minDist = dist; closest = other; }
+                    candidates.push(other.unit, sf::Vector2f(other.x, other.y));
                 }
             }
         }
     }
-    return closest;
+    return candidates.nearest(myPos, 99999.f);
 }
 
 // --- 2. PEKKA (皮卡) ---
 Pekka::Pekka(float x, float y, Team team) : Tank(x, y, team) {
     m_hp = 500.f; m_maxHp = 500.f; m_atk = 80.f; m_speed = 35.f; // 攻极高
     m_attackInterval = 1.8f; // 攻速很慢
-
-    AnimInfo info;
-    info.frameWidth = 231; info.frameHeight = 231; 
-    info.walkFrames = 10; info.attackFrames = 6;
-    info.walkDuration = 0.12f; info.attackDuration = 0.2f;
-
-    initSprite(ResourceManager::getInstance().getTexture("unit_pekka"), info);
+    m_armor = 5.f; // 重甲：弓箭、飞镖这类小伤害打上去效果差
+
+    // 帧表每个兵种只构建一次，所有同类单位共享
+    static const AnimTable table = [] {
+        AnimInfo info;
+        info.frameWidth = 231; info.frameHeight = 231; 
+        info.walkFrames = 10; info.attackFrames = 6;
+        info.walkDuration = 0.12f; info.attackDuration = 0.2f;
+        return AnimTable::build(info, {6, 9, 8, 5, 7}, {4, 2, 1, 3, 0});
+    }();
+
+    initSprite(ResourceManager::getInstance().getTexture(TextureId::UNIT_PEKKA), table);
     setScale(0.3f, 0.3f);
 
-    setAttackRows(4, 2, 1, 3, 0);
-    setWalkRows(6, 9, 8, 5, 7);
-
-    initSounds("sfx_deploy_pekka", "sfx_hit_pekka");
+    initSounds(SoundId::DEPLOY_PEKKA, SoundId::HIT_PEKKA);
 
     initUI(false, 50.f, 6.f, -50.f);
 }
@@ -483,18 +532,19 @@ Pekka::Pekka(float x, float y, Team team) : Tank(x, y, team) {
 Knight::Knight(float x, float y, Team team) : Melee(x, y, team) {
     m_hp = 200.f; m_maxHp = 200.f; m_atk = 20.f; m_speed = 50.f;
 
-    AnimInfo info;
-    info.frameWidth = 187; info.frameHeight = 181; 
-    info.walkFrames = 12; info.attackFrames = 12;
-    info.walkDuration = 0.1f; info.attackDuration = 0.1f;
+    // 帧表每个兵种只构建一次，所有同类单位共享
+    static const AnimTable table = [] {
+        AnimInfo info;
+        info.frameWidth = 187; info.frameHeight = 181; 
+        info.walkFrames = 12; info.attackFrames = 12;
+        info.walkDuration = 0.1f; info.attackDuration = 0.1f;
+        return AnimTable::build(info, {6, 9, 8, 5, 7}, {4, 2, 1, 3, 0});
+    }();
 
-    initSprite(ResourceManager::getInstance().getTexture("unit_knight"), info);
+    initSprite(ResourceManager::getInstance().getTexture(TextureId::UNIT_KNIGHT), table);
     setScale(0.3f, 0.3f);
 
-    setAttackRows(4, 2, 1, 3, 0);
-    setWalkRows(6, 9, 8, 5, 7);
-
-    initSounds("sfx_deploy_knight", "sfx_hit_knight");
+    initSounds(SoundId::DEPLOY_KNIGHT, SoundId::HIT_KNIGHT);
 
     initUI(false, 40.f, 5.f, -40.f);
 }
@@ -504,25 +554,26 @@ Valkyrie::Valkyrie(float x, float y, Team team) : Melee(x, y, team) {
     m_hp = 250.f; m_maxHp = 250.f; m_atk = 18.f; m_speed = 55.f;
     m_attackInterval = 1.2f;
 
-    AnimInfo info;
-    info.frameWidth = 173; info.frameHeight = 153; // 旋风斩图可能比较宽
-    info.walkFrames = 8; info.attackFrames = 12;
-    info.walkDuration = 0.15f; info.attackDuration = 0.1f;
+    // 帧表每个兵种只构建一次，所有同类单位共享
+    static const AnimTable table = [] {
+        AnimInfo info;
+        info.frameWidth = 173; info.frameHeight = 153; // 旋风斩图可能比较宽
+        info.walkFrames = 8; info.attackFrames = 12;
+        info.walkDuration = 0.15f; info.attackDuration = 0.1f;
+        return AnimTable::build(info, {8, 6, 9, 5, 7}, {4, 2, 1, 3, 0});
+    }();
 
-    initSprite(ResourceManager::getInstance().getTexture("unit_valkyrie"), info);
+    initSprite(ResourceManager::getInstance().getTexture(TextureId::UNIT_VALKYRIE), table);
     setScale(0.3f, 0.3f);
 
-    setAttackRows(4, 2, 1, 3, 0);
-    setWalkRows(8, 6, 9, 5, 7);
-
-    initSounds("sfx_deploy_valkyrie", "sfx_hit_valkyrie");
+    initSounds(SoundId::DEPLOY_VALKYRIE, SoundId::HIT_VALKYRIE);
 
     initUI(false, 40.f, 5.f, -35.f);
 }
 
 // 瓦基丽的特色：AOE 攻击
 // 【修改】瓦基丽的旋风斩 (AOE) 使用空间网格加速
-void Valkyrie::performAttack(Unit* target, const std::vector<std::vector<Unit*>>& spatialGrid) {
+void Valkyrie::performAttack(Unit* target, const SpatialGrid& spatialGrid, ProjectileSystem& projectiles, DamageBuffer& damage) {
     float aoeRadius = 60.0f; // AOE 半径 (稍微加大一点)
     
     // 计算周围涉及的格子
@@ -531,23 +582,23 @@ void Valkyrie::performAttack(Unit* target, const std::vector<std::vector<Unit*>>
     int centerRow = static_cast<int>(myPos.y) / Game::TILE_SIZE;
     int searchRadius = static_cast<int>(std::ceil(aoeRadius / Game::TILE_SIZE));
 
+    // 先收集敌方候选，再批量生成半径内的掩码
+    thread_local CandidateBlock candidates;
+    candidates.clear();
     for (int r = centerRow - searchRadius; r <= centerRow + searchRadius; ++r) {
         for (int c = centerCol - searchRadius; c <= centerCol + searchRadius; ++c) {
-            if (r >= 0 && r < Game::ROWS && c >= 0 && c < Game::COLS) {
-                int index = r * Game::COLS + c;
-                for (auto other : spatialGrid[index]) {
-                    if (!other || other->isDead() || other->getTeam() == m_team) continue;
-
-                    sf::Vector2f diff = other->getPosition() - myPos;
-                    float dist = std::sqrt(diff.x * diff.x + diff.y * diff.y);
-
-                    if (dist <= aoeRadius) {
-                        other->takeDamage(m_atk);
-                    }
+            if (spatialGrid.inBounds(r, c)) {
+                for (const SpatialGrid::Entry& other : spatialGrid.cell(r, c)) {
+                    if (other.team == m_team) continue;
+                    candidates.push(other.unit, sf::Vector2f(other.x, other.y));
                 }
             }
         }
     }
+
+    for (int i : candidates.within(myPos, aoeRadius)) {
+        damage.submit(candidates.units[i], m_atk);
+    }
 }
 
 // --- 5. Archers (弓箭手) ---
@@ -555,18 +606,19 @@ Archers::Archers(float x, float y, Team team) : Ranged(x, y, team) {
     m_hp = 80.f; m_maxHp = 80.f; m_atk = 12.f; m_speed = 65.f; 
     m_range = 150.f;
 
-    AnimInfo info;
-    info.frameWidth = 130; info.frameHeight = 135; 
-    info.walkFrames = 8; info.attackFrames = 5;
-    info.walkDuration = 0.15f; info.attackDuration = 0.24f;
+    // 帧表每个兵种只构建一次，所有同类单位共享
+    static const AnimTable table = [] {
+        AnimInfo info;
+        info.frameWidth = 130; info.frameHeight = 135; 
+        info.walkFrames = 8; info.attackFrames = 5;
+        info.walkDuration = 0.15f; info.attackDuration = 0.24f;
+        return AnimTable::build(info, {9, 6, 8, 5, 7}, {4, 2, 1, 3, 0});
+    }();
 
-    initSprite(ResourceManager::getInstance().getTexture("unit_archers"), info);
+    initSprite(ResourceManager::getInstance().getTexture(TextureId::UNIT_ARCHERS), table);
     setScale(0.32f, 0.32f);
 
-    setAttackRows(4, 2, 1, 3, 0);
-    setWalkRows(9, 6, 8, 5, 7);
-
-    initSounds("sfx_deploy_archers", "sfx_hit_archers");
+    initSounds(SoundId::DEPLOY_ARCHERS, SoundId::HIT_ARCHERS);
 
     initUI(false, 30.f, 4.f, -30.f);
 }
@@ -576,19 +628,22 @@ DartGoblin::DartGoblin(float x, float y, Team team) : Ranged(x, y, team) {
     m_hp = 50.f; m_maxHp = 50.f; m_atk = 15.f; m_speed = 90.f; // 极快
     m_range = 200.f; // 射程极远
     m_attackInterval = 0.5f; // 攻速极快
-
-    AnimInfo info;
-    info.frameWidth = 129; info.frameHeight = 141; 
-    info.walkFrames = 8; info.attackFrames = 5;
-    info.walkDuration = 0.15f; info.attackDuration = 0.24f;
-
-    initSprite(ResourceManager::getInstance().getTexture("unit_dartgoblin"), info);
+    m_thinkInterval = 2; // 又快又远，决策间隔最短
+    m_projectileKind = ProjectileKind::DART; // 吹箭飞得比箭快
+
+    // 帧表每个兵种只构建一次，所有同类单位共享
+    static const AnimTable table = [] {
+        AnimInfo info;
+        info.frameWidth = 129; info.frameHeight = 141; 
+        info.walkFrames = 8; info.attackFrames = 5;
+        info.walkDuration = 0.15f; info.attackDuration = 0.24f;
+        return AnimTable::build(info, {6, 9, 8, 5, 7}, {4, 2, 1, 3, 0});
+    }();
+
+    initSprite(ResourceManager::getInstance().getTexture(TextureId::UNIT_DARTGOBLIN), table);
     setScale(0.31f, 0.21f);
 
-    setAttackRows(4, 2, 1, 3, 0);
-    setWalkRows(6, 9, 8, 5, 7);
-
-    initSounds("sfx_deploy_dartgoblin", "sfx_hit_dartgoblin");
+    initSounds(SoundId::DEPLOY_DARTGOBLIN, SoundId::HIT_DARTGOBLIN);
 
     initUI(false, 30.f, 4.f, -30.f);
 }
\ No newline at end of file
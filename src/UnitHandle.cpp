@@ -0,0 +1,36 @@
+#include "UnitHandle.h"
+#include "EventBus.h"
+#include "Unit.h"
+
+void UnitHandleTable::attach(EventBus& bus) {
+    bus.subscribe(GameEventType::UNIT_SPAWNED, [this](const GameEvent& e) { e.unit->setHandle(add(e.unit)); });
+    // 单位删除前会发布下面两个事件之一
+    auto onRemoved = [this](const GameEvent& e) {
+        remove(e.unit->getHandle());
+        e.unit->setHandle(UnitHandle());
+    };
+    bus.subscribe(GameEventType::TOWER_DESTROYED, onRemoved);
+    bus.subscribe(GameEventType::UNIT_DIED, onRemoved);
+}
+
+UnitHandle UnitHandleTable::add(Unit* unit) {
+    std::uint32_t index;
+    if (!m_free.empty()) {
+        index = m_free.back();
+        m_free.pop_back();
+    } else {
+        index = static_cast<std::uint32_t>(m_slots.size());
+        m_slots.emplace_back();
+    }
+    m_slots[index].unit = unit;
+    return UnitHandle{ index, m_slots[index].generation };
+}
+
+void UnitHandleTable::remove(UnitHandle handle) {
+    if (get(handle) == nullptr) return;
+    Slot& slot = m_slots[handle.index];
+    slot.unit = nullptr;
+    // 代数加一让旧句柄失效 (跳过 0，0 留给空句柄)
+    if (++slot.generation == 0) slot.generation = 1;
+    m_free.push_back(handle.index);
+}
@@ -1,11 +1,91 @@
 #include "Game.h"
+#include "Unit.h"
+#include "Profiler.h"
+#include "Scenario.h"
 #include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
 
-int main()
+int main(int argc, char* argv[])
 {
+    // 可选参数:
+    //   --map <文件>          载入地图 (.map 文本 或 .bmap 二进制)
+    //   --size <行>x<列>      不读文件，程序化生成指定大小的战场
+    //   --think-scale <倍率>  单位决策间隔的全局倍率 (默认 1，越大 AI 越省 CPU、反应越慢)
+    //   --trace <文件>        退出时把最近的分段计时导出为 Chrome trace JSON (需要 BATTLESIM_PROFILE)
+    //   --units <数量>        开局按场景给两队铺兵 (两队合计，见 Scenario.h)；没给 --map/--size 且默认地图放不下时按人数生成战场
+    //   --mix <配比>          场景的兵种配比，如 knight:3,archers:1 (默认六个兵种平均)
+    //   --layout <站位>       formation (默认) 或 random
+    std::string mapFile = Game::DEFAULT_MAP_FILE;
+    bool mapGiven = false;
+    int rows = 0, cols = 0;
+    std::string traceFile;
+    ScenarioSpec scenario;
+    int scenarioUnits = 0;
+    for (int i = 1; i + 1 < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--map") {
+            mapFile = argv[++i];
+            mapGiven = true;
+        } else if (arg == "--size") {
+            if (std::sscanf(argv[++i], "%dx%d", &rows, &cols) != 2) {
+                std::cerr << "Usage: BattleSim [--map FILE] [--size ROWSxCOLS] [--think-scale X] [--trace FILE] [--units N] [--mix SPEC] [--layout formation|random]" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--think-scale") {
+            Unit::setThinkScale(static_cast<float>(std::atof(argv[++i])));
+        } else if (arg == "--trace") {
+            traceFile = argv[++i];
+        } else if (arg == "--units") {
+            scenarioUnits = std::atoi(argv[++i]);
+        } else if (arg == "--mix") {
+            if (!Scenario::parseMix(argv[++i], scenario.mix[TEAM_A])) return 1;
+            scenario.mix[TEAM_B] = scenario.mix[TEAM_A];
+        } else if (arg == "--layout") {
+            if (!Scenario::parseLayout(argv[++i], scenario.layout)) return 1;
+        }
+    }
+
+    // 人数多到默认地图铺不开时，照 scaling_bench 的做法按人数生成地图，不然全挤在默认部署区里叠放
+    if (scenarioUnits > 0 && rows <= 0 && !mapGiven) {
+        int fitRows = 0, fitCols = 0;
+        Scenario::fitMapSize(scenarioUnits, fitRows, fitCols);
+        if (fitRows > Game::DEFAULT_ROWS || fitCols > Game::DEFAULT_COLS) {
+            rows = fitRows;
+            cols = fitCols;
+        }
+    }
+
+    MapData map;
+    bool loaded = (rows > 0) ? MapFile::generate(rows, cols, map) : MapFile::load(mapFile, map);
+    if (!loaded) {
+        // 地图文件缺失或损坏时，退回默认大小的程序化地图，保证游戏能启动
+        std::cerr << "[Main] Falling back to a generated default map" << std::endl;
+        MapFile::generate(Game::DEFAULT_ROWS, Game::DEFAULT_COLS, map);
+    }
+
     // 创建并运行游戏实例
-    Game game;
+    Game game(std::move(map));
+    if (scenarioUnits > 0) {
+        scenario.unitsPerTeam[TEAM_A] = scenarioUnits / 2;
+        scenario.unitsPerTeam[TEAM_B] = scenarioUnits - scenarioUnits / 2;
+        Scenario::populate(game, scenario);
+    }
     game.run();
 
+    if (!traceFile.empty()) {
+#ifdef BATTLESIM_PROFILE
+        Profiler::printSummary(std::cout);
+        if (Profiler::writeChromeTrace(traceFile)) {
+            std::cout << "[Main] Trace written to " << traceFile << std::endl;
+        } else {
+            std::cerr << "[Main] Failed to write trace " << traceFile << std::endl;
+        }
+#else
+        std::cerr << "[Main] Built without BATTLESIM_PROFILE, --trace ignored" << std::endl;
+#endif
+    }
+
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,78 @@
+// 离线资源打包工具
+// 用法: asset_packer <资源根目录> <输出 assets.pak>
+//
+// 按 AssetManifest.h 的清单逐个读入资源，把 PNG 解码成 RGBA、OGG 解码成 PCM，
+// 写成一个 assets.pak。游戏启动时直接 mmap 这个文件，不再做任何解码。
+#include <SFML/Graphics.hpp>
+#include <SFML/Audio.hpp>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include "AssetArchive.h"
+#include "AssetManifest.h"
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: asset_packer <asset_root> <output.pak>" << std::endl;
+        return 1;
+    }
+    std::string root = argv[1];
+    std::string output = argv[2];
+
+    AssetArchiveWriter writer;
+    int failures = 0;
+
+    for (const auto& entry : ASSET_MANIFEST) {
+        std::string fileName = root + "/" + entry.path;
+
+        switch (entry.kind) {
+            case AssetKind::TEXTURE: {
+                sf::Image image;
+                if (!image.loadFromFile(fileName)) {
+                    std::cerr << "[Packer] ERROR: Failed to decode image: " << fileName << std::endl;
+                    failures++;
+                    break;
+                }
+                sf::Vector2u size = image.getSize();
+                writer.add(entry.name, entry.kind, image.getPixelsPtr(),
+                           static_cast<std::uint64_t>(size.x) * size.y * 4, size.x, size.y);
+                std::cout << "[Packer] Texture " << entry.name << " " << size.x << "x" << size.y << std::endl;
+                break;
+            }
+            case AssetKind::SOUND: {
+                sf::SoundBuffer buffer;
+                if (!buffer.loadFromFile(fileName)) {
+                    std::cerr << "[Packer] ERROR: Failed to decode sound: " << fileName << std::endl;
+                    failures++;
+                    break;
+                }
+                writer.add(entry.name, entry.kind, buffer.getSamples(),
+                           buffer.getSampleCount() * sizeof(sf::Int16),
+                           buffer.getChannelCount(), buffer.getSampleRate(), buffer.getSampleCount());
+                std::cout << "[Packer] Sound " << entry.name << " " << buffer.getSampleCount() << " samples" << std::endl;
+                break;
+            }
+            case AssetKind::FONT: {
+                // 字体保持 TTF 原样，FreeType 可以直接从映射内存读
+                std::ifstream in(fileName, std::ios::binary);
+                std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+                if (!in.good() && !in.eof()) bytes.clear();
+                if (bytes.empty()) {
+                    std::cerr << "[Packer] ERROR: Failed to read font: " << fileName << std::endl;
+                    failures++;
+                    break;
+                }
+                writer.add(entry.name, entry.kind, bytes.data(), bytes.size());
+                std::cout << "[Packer] Font " << entry.name << " " << bytes.size() << " bytes" << std::endl;
+                break;
+            }
+        }
+    }
+
+    if (!writer.write(output)) {
+        std::cerr << "[Packer] ERROR: Cannot write " << output << std::endl;
+        return 1;
+    }
+    std::cout << "[Packer] Wrote " << output << (failures ? " (with errors)" : "") << std::endl;
+    return failures ? 1 : 0;
+}
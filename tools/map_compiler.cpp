@@ -0,0 +1,52 @@
+// 地图编译工具
+// 用法:
+//   map_compiler <输入.map|.bmap> <输出.map|.bmap>
+//       文本/二进制互转 (按输出扩展名决定格式)
+//   map_compiler --generate <行> <列> [山脉密度 0..1] [随机种子] <输出.map|.bmap>
+//       程序化生成任意大小的战场，例如 1000x1000 的寻路/人群压力测试图
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "MapFile.h"
+
+namespace {
+    bool endsWith(const std::string& s, const std::string& suffix) {
+        return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    bool save(const std::string& fileName, const MapData& map) {
+        bool ok = endsWith(fileName, ".bmap") ? MapFile::saveBinary(fileName, map) : MapFile::saveText(fileName, map);
+        if (!ok) std::cerr << "[MapCompiler] ERROR: Cannot write " << fileName << std::endl;
+        return ok;
+    }
+
+    int usage() {
+        std::cerr << "Usage: map_compiler <input> <output.map|output.bmap>\n"
+                  << "       map_compiler --generate <rows> <cols> [density] [seed] <output.map|output.bmap>" << std::endl;
+        return 1;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) return usage();
+
+    MapData map;
+    std::string output;
+
+    if (std::string(argv[1]) == "--generate") {
+        if (argc < 5) return usage();
+        int rows = std::atoi(argv[2]);
+        int cols = std::atoi(argv[3]);
+        float density = argc > 5 ? static_cast<float>(std::atof(argv[4])) : 0.f;
+        unsigned seed = argc > 6 ? static_cast<unsigned>(std::strtoul(argv[5], nullptr, 10)) : 1u;
+        output = argv[argc - 1];
+        if (!MapFile::generate(rows, cols, map, density, seed)) return 1;
+    } else {
+        output = argv[2];
+        if (!MapFile::load(argv[1], map)) return 1;
+    }
+
+    if (!save(output, map)) return 1;
+    std::cout << "[MapCompiler] Wrote " << output << " (" << map.tiles.rows() << "x" << map.tiles.cols() << ")" << std::endl;
+    return 0;
+}